@@ -0,0 +1,150 @@
+#include "Attacks.hpp"
+
+#include <bit>
+#include <cassert>
+#include <initializer_list>
+
+namespace chess {
+    namespace internal {
+        SliderMagic rookMagics[64];
+        SliderMagic bishopMagics[64];
+        uint64_t betweenTable[64][64];
+        uint64_t lineTable[64][64];
+    }
+
+    namespace {
+        // number of relevant occupancies summed over all squares
+        uint64_t rookTable[0x19000];
+        uint64_t bishopTable[0x1480];
+
+        constexpr int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        constexpr int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+        constexpr uint64_t firstRank = 0xffull;
+        constexpr uint64_t lastRank = 0xffull << 7u * 8u;
+        constexpr uint64_t firstFile = 0x0101010101010101ull;
+        constexpr uint64_t lastFile = firstFile << 7u;
+
+        /**
+         * Computes the attacks of a slider by walking every ray until it hits an occupied square
+         * Only used to fill the tables, lookups go through Attacks.
+         */
+        uint64_t slidingAttack(const int (&directions)[4][2], unsigned square, uint64_t occupied) {
+            uint64_t attack = 0;
+            for (const auto &direction : directions) {
+                int x = static_cast<int>(square % 8) + direction[0];
+                int y = static_cast<int>(square / 8) + direction[1];
+                while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+                    uint64_t mask = 1ull << (x + 8 * y);
+                    attack |= mask;
+                    if (occupied & mask) break;
+                    x += direction[0];
+                    y += direction[1];
+                }
+            }
+            return attack;
+        }
+
+        /**
+         * Magic factors for the square indexing of Bitboard (bit 0 is h1).
+         * Found once by a random search over sparse numbers, any factor without destructive collisions works.
+         */
+        constexpr uint64_t rookMagicFactors[64] = {
+                0x1080004008801020ull, 0x0840092002c03000ull, 0x1900200010400900ull, 0x0880100008000480ull,
+                0x4200100420080200ull, 0x8100020100080400ull, 0x0200040110886200ull, 0x0200008040220411ull,
+                0x0404800084400220ull, 0x0000401000402000ull, 0x0086001081220440ull, 0x0408800800100280ull,
+                0x000a001201040820ull, 0x8848800200840080ull, 0x4001000100040200ull, 0x0442000102105084ull,
+                0x9080010020804100ull, 0x0040404000201009ull, 0x0000808010002009ull, 0x2200090021d00100ull,
+                0x0008008008040080ull, 0x0004004002010040ull, 0x0011040008015042ull, 0x00000a0001768104ull,
+                0x0000800080204009ull, 0x2010004140002001ull, 0x9800200280100080ull, 0x1000100080080080ull,
+                0x0442000a00049020ull, 0x2100040080020080ull, 0x0800120400900148ull, 0x0010040a00128541ull,
+                0x2800804000800030ull, 0x1010002000400041ull, 0x4000200011004100ull, 0x0610008410800800ull,
+                0x0400802402800800ull, 0xc100020080800400ull, 0x0002000802000401ull, 0x0182085882000401ull,
+                0x0220204000808000ull, 0x2860100040024022ull, 0x0001002004110040ull, 0x99101042000a0020ull,
+                0x0004080004008080ull, 0x0010040002008080ull, 0x2012004881020004ull, 0x8300842444820011ull,
+                0x0088403882010200ull, 0x0820400080210100ull, 0x0110910040a00300ull, 0x0801100280080480ull,
+                0x0242009008200600ull, 0x1002000489500200ull, 0x0040800200010080ull, 0x0091800041000080ull,
+                0x0000209300488001ull, 0x04c1002414824001ull, 0x020020000b001041ull, 0x7000100004200901ull,
+                0x8002002004100802ull, 0x30010002084c0007ull, 0x0888221800813004ull, 0x4000002840840112ull
+        };
+
+        constexpr uint64_t bishopMagicFactors[64] = {
+                0x10102002004a1420ull, 0x8020040400584008ull, 0x10510800811201c8ull, 0x5204042080000088ull,
+                0x2204106880000002ull, 0x1401042004000000ull, 0x0400880410042004ull, 0x0028208200a02020ull,
+                0x1500241990010e00ull, 0x8001200182020a40ull, 0x40004101030b0000ull, 0x8002041042000100ull,
+                0x4010011041020038ull, 0x0000010421044000ull, 0x1500210808020a00ull, 0x8000088400880520ull,
+                0x0405004010040100ull, 0x1005823210040108ull, 0x2708008102040011ull, 0x4048200404009100ull,
+                0x0018104101400024ull, 0x0003000601190101ull, 0x8004803108491000ull, 0x8014241200820800ull,
+                0x0006e080100c3040ull, 0x0501044a11041800ull, 0x9020300008004045ull, 0x0894080000220040ull,
+                0x1001010083104000ull, 0x5004030040900080ull, 0x000400422c012400ull, 0x0002128698404812ull,
+                0x1010108404900440ull, 0x0928021182084100ull, 0x2006080409020024ull, 0x1010202020180080ull,
+                0xa010008200202200ull, 0x2098015100019004ull, 0x0002041440810811ull, 0x802a02020000b098ull,
+                0x0009015090004060ull, 0x4000821082081001ull, 0x0100210040420800ull, 0x0800004010488a00ull,
+                0x2000081104004040ull, 0x4c8e029015000082ull, 0x0420340322224842ull, 0x1298260043400210ull,
+                0x0000822802400008ull, 0x00008a0101600000ull, 0x3040003412080021ull, 0x3040290220884800ull,
+                0x4a1500401041004aull, 0x8010200282020781ull, 0x0020203142209091ull, 0x0070300600902110ull,
+                0x0040808800b62048ull, 0x0000810400c44420ull, 0x00080400440c0441ull, 0x8340080020840411ull,
+                0x0000000104208200ull, 0x0000800810d00080ull, 0x0400530411080200ull, 0x4040702400932244ull
+        };
+
+        void initSliderMagics(internal::SliderMagic (&magics)[64], uint64_t *table, const int (&directions)[4][2],
+                              const uint64_t (&magicFactors)[64]) {
+            uint64_t *attacks = table;
+            for (unsigned square = 0; square < 64; square++) {
+                auto &magic = magics[square];
+                uint64_t squareRank = firstRank << (square / 8 * 8);
+                uint64_t squareFile = firstFile << (square % 8);
+                // pieces on the edge never block a ray
+                uint64_t edges = ((firstRank | lastRank) & ~squareRank) | ((firstFile | lastFile) & ~squareFile);
+
+                magic.mask = slidingAttack(directions, square, 0) & ~edges;
+                magic.magic = magicFactors[square];
+                magic.shift = 64 - std::popcount(magic.mask);
+                magic.attacks = attacks;
+
+                // enumerate all subsets of the mask (carry rippler)
+                unsigned size = 0;
+                uint64_t occupied = 0;
+                do {
+                    uint64_t attack = slidingAttack(directions, square, occupied);
+                    unsigned index = magic.index(occupied);
+                    // every slot is either unused or shared by occupancies with the same attacks
+                    assert(attacks[index] == 0 || attacks[index] == attack);
+                    attacks[index] = attack;
+                    size++;
+                    occupied = (occupied - magic.mask) & magic.mask;
+                } while (occupied != 0);
+
+                attacks += size;
+            }
+        }
+
+        void initLines() {
+            for (unsigned from = 0; from < 64; from++) {
+                for (unsigned to = 0; to < 64; to++) {
+                    internal::betweenTable[from][to] = 0;
+                    internal::lineTable[from][to] = 0;
+                    if (from == to) continue;
+                    uint64_t fromMask = 1ull << from;
+                    uint64_t toMask = 1ull << to;
+                    for (const auto *directions : {&rookDirections, &bishopDirections}) {
+                        if ((slidingAttack(*directions, from, 0) & toMask) == 0) continue;
+                        internal::lineTable[from][to] = (slidingAttack(*directions, from, 0) &
+                                                         slidingAttack(*directions, to, 0)) | fromMask | toMask;
+                        internal::betweenTable[from][to] = slidingAttack(*directions, from, toMask) &
+                                                           slidingAttack(*directions, to, fromMask);
+                    }
+                }
+            }
+        }
+
+        bool initAttacks() {
+            initSliderMagics(internal::rookMagics, rookTable, rookDirections, rookMagicFactors);
+            initSliderMagics(internal::bishopMagics, bishopTable, bishopDirections, bishopMagicFactors);
+            initLines();
+            return true;
+        }
+
+        [[maybe_unused]] const bool attacksInitialized = initAttacks();
+    }
+}
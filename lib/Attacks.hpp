@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef CHESS_USE_PEXT
+#include <immintrin.h>
+#endif
+
+namespace chess {
+    namespace internal {
+        /**
+         * Lookup data of one square for a single slider type.
+         * The index into the attack table is either found by a magic multiplication or by PEXT.
+         */
+        struct SliderMagic {
+            uint64_t mask;
+            uint64_t magic;
+            uint64_t *attacks;
+            unsigned shift;
+
+            [[nodiscard]] unsigned index(uint64_t occupied) const {
+#ifdef CHESS_USE_PEXT
+                return _pext_u64(occupied, mask);
+#else
+                return ((occupied & mask) * magic) >> shift;
+#endif
+            }
+        };
+
+        extern SliderMagic rookMagics[64];
+        extern SliderMagic bishopMagics[64];
+        extern uint64_t betweenTable[64][64];
+        extern uint64_t lineTable[64][64];
+    }
+
+    /**
+     * Precomputed attack tables. All tables are filled once during static initialization.
+     */
+    class Attacks {
+    public:
+        /**
+         * @param square square of the rook
+         * @param occupied all pieces blocking the rays, the rook itself may be included
+         * @return bitmap of all squares attacked by a rook, including the first blocker on each ray
+         */
+        static uint64_t rook(unsigned square, uint64_t occupied) {
+            const auto &magic = internal::rookMagics[square];
+            return magic.attacks[magic.index(occupied)];
+        }
+
+        /**
+         * @param square square of the bishop
+         * @param occupied all pieces blocking the rays, the bishop itself may be included
+         * @return bitmap of all squares attacked by a bishop, including the first blocker on each ray
+         */
+        static uint64_t bishop(unsigned square, uint64_t occupied) {
+            const auto &magic = internal::bishopMagics[square];
+            return magic.attacks[magic.index(occupied)];
+        }
+
+        static uint64_t queen(unsigned square, uint64_t occupied) {
+            return rook(square, occupied) | bishop(square, occupied);
+        }
+
+        /**
+         * @return squares strictly between two squares on a common rank, file or diagonal, otherwise 0
+         */
+        static uint64_t between(unsigned from, unsigned to) { return internal::betweenTable[from][to]; }
+
+        /**
+         * @return the whole rank, file or diagonal through both squares, otherwise 0
+         */
+        static uint64_t line(unsigned from, unsigned to) { return internal::lineTable[from][to]; }
+    };
+}
@@ -1,4 +1,6 @@
 #include "Bitboard.hpp"
+#include "Attacks.hpp"
+#include "Zobrist.hpp"
 
 #include <cassert>
 #include <cstring>
@@ -8,13 +10,41 @@
 
 namespace chess {
     namespace {
-        constexpr void assertOffset(int left, int up) {
+        constexpr void assertOffset([[maybe_unused]] int left, [[maybe_unused]] int up) {
             assert(left < 8);
             assert(left > -8);
             assert(up < 8);
             assert(up > -8);
             assert(up != 0 or left != 0);
         }
+
+        /**
+         * Direction of a piece step, usable as template argument so the shifts and masks become constants
+         */
+        struct Offset {
+            int left;
+            int up;
+        };
+
+        /**
+         * Calls f.template operator()<offset>() for each offset, which unrolls direction loops at compile time
+         */
+        template<Offset... offsets, typename F>
+        constexpr void forEachOffset(F &&f) {
+            (f.template operator()<offsets>(), ...);
+        }
+
+        template<typename F>
+        constexpr void forEachKingOffset(F &&f) {
+            forEachOffset<Offset{-1, -1}, Offset{-1, 0}, Offset{-1, 1}, Offset{0, -1}, Offset{0, 1}, Offset{1, -1},
+                          Offset{1, 0}, Offset{1, 1}>(f);
+        }
+
+        template<typename F>
+        constexpr void forEachKnightOffset(F &&f) {
+            forEachOffset<Offset{-2, -1}, Offset{-2, 1}, Offset{-1, -2}, Offset{-1, 2}, Offset{1, -2}, Offset{1, 2},
+                          Offset{2, -1}, Offset{2, 1}>(f);
+        }
     }
 
     void Bitboard::evalAttack() const {
@@ -37,113 +67,94 @@ namespace chess {
         controlled = 0;
         checks = 0;
         cachedAttack = false;
-        legalMovesCache.reset();
     }
 
     void Bitboard::evalPawnAttack() const {
-        int up = pov ? -1 : 1;
-        uint64_t enemyPawns = getOccupied(!pov) & pawns;
-        uint64_t ownKing = getOccupied(pov) & kings;
-        for (int left : {-1, 1}) {
-            uint64_t pawnControlled = applyOffset(left, up, enemyPawns & canMoveToMask(left, up));
+        if (pov) evalPawnAttack<true>();
+        else evalPawnAttack<false>();
+    }
+
+    template<bool white>
+    void Bitboard::evalPawnAttack() const {
+        constexpr int up = white ? -1 : 1;
+        uint64_t enemyPawns = getOccupied(!white) & pawns;
+        uint64_t ownKing = getOccupied(white) & kings;
+        forEachOffset<Offset{-1, up}, Offset{1, up}>([&]<Offset offset>() {
+            uint64_t pawnControlled = applyOffset<offset.left, offset.up>(
+                    enemyPawns & canMoveToMask<offset.left, offset.up>());
             controlled |= pawnControlled;
             // pawn attacking king
             if (pawnControlled & ownKing) {
-                checks |= applyOffset(-left, -up, ownKing);
+                checks |= applyOffset<-offset.left, -offset.up>(ownKing);
             }
-        }
+        });
     }
 
     void Bitboard::evalQueenLikeAttack() const {
-        for (int dleft : {-1, 0, 1}) {
-            for (int dup : {-1, 0, 1}) {
-                if (dleft == 0 && dup == 0) continue;
-                evalQueenLikeAttackXray(dleft, dup);
-            }
-        }
-    }
-
-    void Bitboard::evalQueenLikeAttackXray(int dleft, int dup) const {
-        assert(dleft < 2 && dleft > -2);
-        assert(dup < 2 && dup > -2);
-        assert(dleft != 0 || dup != 0);
-
-        uint64_t lastFree = ~0ull;
-        uint64_t xRayActive = 0;
-        uint64_t xRayLevel[8] = {0};
-
         uint64_t ownKing = getOccupied(pov) & kings;
-        uint64_t ownNonKing = getOccupied(pov) & (~ownKing);
-        uint64_t pinAttacker = 0;
-
-        uint64_t relevantEnemyPieces = (queens | ((dleft == 0 || dup == 0) ? rooks : bishops)) & getOccupied(!pov);
-        for (int step = 1; step < 8; step++) {
-            int left = dleft * step;
-            int up = dup * step;
-
-            uint64_t enemyControlled = applyOffset(left, up, relevantEnemyPieces & lastFree & canMoveToMask(left, up));
-            uint64_t enemyControlledPieces = enemyControlled & ownNonKing;
-            uint64_t enemyXrayControlled = applyOffset(left, up,
-                                                       relevantEnemyPieces & xRayActive & canMoveToMask(left, up));
-            uint64_t enemyXrayContolledOccupied = enemyXrayControlled & occupied();
-
-            // update last free
-            lastFree &= applyOffset(-left, -up, enemyControlled & (~occupied() | ownKing));
-            // mark piece that is the reason for a pin
-            pinAttacker |= applyOffset(-left, -up, enemyXrayControlled & ownKing);
-            // deactivate xray on second collision
-            xRayActive &= ~applyOffset(-left, -up, enemyXrayContolledOccupied);
-            // activate xray on controlled pieces
-            xRayLevel[step] = applyOffset(-left, -up, enemyControlledPieces);
-            xRayActive |= xRayLevel[step];
-            // mark checks where enemy attacks king
-            checks |= applyOffset(-left, -up, enemyControlled & ownKing);
-            controlled |= enemyControlled;
-        }
-        if (pinAttacker) {
-            for (int step = 1; step < 8; step++) {
-                relevantPinMap(dleft, dup) |= applyOffset(step * dleft, step * dup, xRayLevel[step] & pinAttacker);
-            }
+        uint64_t enemyRookLike = (queens | rooks) & getOccupied(!pov);
+        uint64_t enemyBishopLike = (queens | bishops) & getOccupied(!pov);
+        // rays pass through the own king, so it cannot step back along an attacking ray
+        uint64_t blockers = occupied() & ~ownKing;
+
+        for (uint64_t pieces = enemyRookLike; pieces != 0; pieces &= pieces - 1) {
+            controlled |= Attacks::rook(std::countr_zero(pieces), blockers);
+        }
+        for (uint64_t pieces = enemyBishopLike; pieces != 0; pieces &= pieces - 1) {
+            controlled |= Attacks::bishop(std::countr_zero(pieces), blockers);
         }
 
+        if (ownKing == 0) return;
+        unsigned kingSquare = std::countr_zero(ownKing);
+        checks |= Attacks::rook(kingSquare, occupied()) & enemyRookLike;
+        checks |= Attacks::bishop(kingSquare, occupied()) & enemyBishopLike;
+
+        // enemy sliders that would attack the king if no own piece was in the way
+        uint64_t pinAttackers = (Attacks::rook(kingSquare, getOccupied(!pov)) & enemyRookLike) |
+                                (Attacks::bishop(kingSquare, getOccupied(!pov)) & enemyBishopLike);
+        for (; pinAttackers != 0; pinAttackers &= pinAttackers - 1) {
+            unsigned attackerSquare = std::countr_zero(pinAttackers);
+            uint64_t between = Attacks::between(kingSquare, attackerSquare) & occupied();
+            // pinned if exactly one own piece and nothing else is in between
+            if (std::popcount(between) != 1 || (between & getOccupied(pov)) == 0) continue;
+
+            int dx = static_cast<int>(attackerSquare % 8) - static_cast<int>(kingSquare % 8);
+            int dy = static_cast<int>(attackerSquare / 8) - static_cast<int>(kingSquare / 8);
+            relevantPinMap((dx > 0) - (dx < 0), (dy > 0) - (dy < 0)) |= between;
+        }
     }
 
     void Bitboard::evalKingAttack() const {
         // mark all squares around king as controlled
         uint64_t enemyKing = getOccupied(!pov) & kings;
-        for (int left : {-1, 0, 1}) {
-            for (int up : {-1, 0, 1}) {
-                if (left == 0 && up == 0) continue;
-                controlled |= applyOffset(left, up, enemyKing & canMoveToMask(left, up));
-            }
-        }
+        forEachKingOffset([&]<Offset offset>() {
+            controlled |= applyOffset<offset.left, offset.up>(enemyKing & canMoveToMask<offset.left, offset.up>());
+        });
     }
 
     void Bitboard::evalKnightAttack() const {
-        int leftArray[] = {-2, -2, -1, -1, 1, 1, 2, 2};
-        int upArray[] = {-1, 1, -2, 2, -2, 2, -1, 1};
-
         uint64_t ownKing = getOccupied(pov) & kings;
         uint64_t enemyKnights = getOccupied(!pov) & knights;
-        for (int i = 0; i < 8; i++) {
-            int left = leftArray[i];
-            int up = upArray[i];
-
-            uint64_t enemyKnightControlled = applyOffset(left, up, enemyKnights & canMoveToMask(left, up));
+        forEachKnightOffset([&]<Offset offset>() {
+            uint64_t enemyKnightControlled = applyOffset<offset.left, offset.up>(
+                    enemyKnights & canMoveToMask<offset.left, offset.up>());
             controlled |= enemyKnightControlled;
 
-            checks |= applyOffset(-left, -up, enemyKnightControlled & ownKing);
-
-
-        }
+            checks |= applyOffset<-offset.left, -offset.up>(enemyKnightControlled & ownKing);
+        });
+    }
 
+    void Bitboard::evalEnPassantPin() const {
+        if (pov) evalEnPassantPin<true>();
+        else evalEnPassantPin<false>();
     }
 
+    template<bool white>
     void Bitboard::evalEnPassantPin() const {
         if (!enPassantFile.has_value()) return;
-        uint8_t rankShift = (pov ? 4 : 3) * 8;
-        uint64_t relevantRank = 0xffull << rankShift;
-        uint64_t ownKingsOnRelevantRank = kings & getOccupied(pov) & relevantRank;
+        constexpr uint8_t rankShift = (white ? 4 : 3) * 8;
+        constexpr uint64_t relevantRank = 0xffull << rankShift;
+        uint64_t ownKingsOnRelevantRank = kings & getOccupied(white) & relevantRank;
         if (ownKingsOnRelevantRank == 0) return;
 
         uint8_t ownKingIdx = std::countr_zero(ownKingsOnRelevantRank);
@@ -151,7 +162,7 @@ namespace chess {
 
         uint64_t rightSideMask = (1ull << (enPassantFile.value() + rankShift)) - 1;
         uint64_t correctSideMask = (isKingLeftOfEnPassant ? rightSideMask : ~rightSideMask) & relevantRank;
-        uint64_t enemyRookLikeCorrectSide = (queens | rooks) & getOccupied(!pov) & correctSideMask;
+        uint64_t enemyRookLikeCorrectSide = (queens | rooks) & getOccupied(!white) & correctSideMask;
         if (enemyRookLikeCorrectSide == 0) return;
 
         uint8_t enemyRookIdx = isKingLeftOfEnPassant ? 63 - std::countl_zero(enemyRookLikeCorrectSide)
@@ -165,7 +176,7 @@ namespace chess {
         if (pawnsBetween != occupiedBetween) return;
         if (std::popcount(pawnsBetween) != 2) return;
 
-        pinnedEnPassant = pawnsBetween & getOccupied(pov);
+        pinnedEnPassant = pawnsBetween & getOccupied(white);
     }
 
     void Bitboard::evalEnPassantLegality() {
@@ -204,16 +215,18 @@ namespace chess {
         std::string_view castling_fen = fen.substr(color_fen_end + 1, castling_fen_end - color_fen_end - 1);
         std::string_view en_passant_fen = fen.substr(castling_fen_end + 1, en_passant_fen_end - castling_fen_end - 1);
         std::string_view half_move_fen = fen.substr(en_passant_fen_end + 1, half_move_fen_end - en_passant_fen_end - 1);
+        std::string_view full_move_fen = half_move_fen_end == std::string_view::npos ? "" : fen.substr(half_move_fen_end + 1);
 
         parseBoardFEN(board_fen);
         parsePovFEN(color_fen);
         parseCastlingFEN(castling_fen);
         parseEnPassantFEN(en_passant_fen);
         parseHalfMoveFEN(half_move_fen);
+        parseFullMoveFEN(full_move_fen);
 
         resetCachedAttack();
         evalEnPassantLegality();
-
+        hash = computeHash();
     }
 
     void Bitboard::parseBoardFEN(std::string_view boardFen) {
@@ -292,9 +305,15 @@ namespace chess {
     }
 
     void Bitboard::parseHalfMoveFEN(std::string_view halfMoveFen) {
+        halfMoveCounter = 0;
         std::from_chars(halfMoveFen.data(), halfMoveFen.data()+halfMoveFen.size(), halfMoveCounter);
     }
 
+    void Bitboard::parseFullMoveFEN(std::string_view fullMoveFen) {
+        moveCounter = 1;
+        std::from_chars(fullMoveFen.data(), fullMoveFen.data()+fullMoveFen.size(), moveCounter);
+    }
+
     std::string Bitboard::to_fen() const { throw std::logic_error("Not implemented!"); }
 
     std::string Bitboard::to_string() const {
@@ -333,20 +352,33 @@ namespace chess {
         occupiedBlack = occupiedWhite << 6u * 8u;
 
         halfMoveCounter = 0;
+        moveCounter = 1;
 
         pov = true;
         castlingRights.set();
         enPassantFile.reset();
         resetCachedAttack();
+        hash = computeHash();
     }
 
-    void Bitboard::applyMoveSelf(const Move &move) {
-        uint64_t fromMask = 1ull << move.fromSquare;
-        uint64_t toMask = 1ull << move.toSquare;
+    Bitboard::Undo Bitboard::applyMoveSelf(const Move &move) {
+        uint64_t fromMask = 1ull << move.fromSquare();
+        uint64_t toMask = 1ull << move.toSquare();
 
         bool isPawn = pawns & fromMask;
         bool isKing = kings & fromMask;
-        bool toBackRank = move.toSquare < 8 || move.toSquare > 55;
+        bool toBackRank = move.toSquare() < 8 || move.toSquare() > 55;
+
+        char movedPiece = pieceAt(move.fromSquare());
+        Undo undo{move, pieceAt(move.toSquare()), false, castlingRights, enPassantFile, halfMoveCounter, hash};
+
+        // remove old castling and en passant keys, they are added again after the move
+        hash ^= Zobrist::castling(castlingRights);
+        if (enPassantFile.has_value()) hash ^= Zobrist::enPassant(enPassantFile.value());
+        if (undo.captured != 0) hash ^= Zobrist::piece(!pov, undo.captured, move.toSquare());
+        hash ^= Zobrist::piece(pov, movedPiece, move.fromSquare());
+        hash ^= Zobrist::piece(pov, move.isPromotion() ? move.promotionPiece() : movedPiece, move.toSquare());
+        hash ^= Zobrist::side();
 
         // promotion
         if (isPawn && toBackRank) {
@@ -354,11 +386,13 @@ namespace chess {
         }
         // castling
         if (isKing && move.fileDistance() == 2) {
-            preApplyCastling(move);
+            moveCastlingRook(move);
         }
         // en passant capture (pawn capturing on a unoccupied square)
         if (isPawn && move.fileDistance() == 1 && toMask & ~occupied()) {
-            preApplyEnPassantCapture(move.toSquare);
+            preApplyEnPassantCapture(move.toSquare());
+            undo.captured = 'p';
+            undo.enPassant = true;
         }
         // toggle en passant
         preApplyToggleEnPassant(move);
@@ -377,21 +411,134 @@ namespace chess {
         // increment move counter
         moveCounter += pov ? 0 : 1;
         // play actual move
-        movePiece(move.fromSquare, move.toSquare);
+        movePiece(move.fromSquare(), move.toSquare());
         // flip pov
         pov = !pov;
 
         resetCachedAttack();
         // check if enPassant can be captured legally
         evalEnPassantLegality();
+
+        hash ^= Zobrist::castling(castlingRights);
+        if (enPassantFile.has_value()) hash ^= Zobrist::enPassant(enPassantFile.value());
+        assert(hash == computeHash());
+        return undo;
+    }
+
+    void Bitboard::unmakeMove(const Undo &undo) {
+        const Move &move = undo.move;
+        uint64_t fromMask = 1ull << move.fromSquare();
+        uint64_t toMask = 1ull << move.toSquare();
+
+        // flip pov back to the side that played the move
+        pov = !pov;
+        moveCounter -= pov ? 0 : 1;
+        // play move backwards
+        movePiece(move.toSquare(), move.fromSquare());
+        // demote promoted piece
+        if (move.isPromotion()) {
+            pieceBitboard(move.promotionPiece()) &= ~fromMask;
+            pawns |= fromMask;
+        }
+        // move rook back
+        if ((kings & fromMask) && move.fileDistance() == 2) {
+            moveCastlingRook(move);
+        }
+        // restore captured piece
+        if (undo.captured != 0) {
+            uint64_t capturedMask = undo.enPassant ? 1ull << (move.toSquare() + (pov ? -8 : 8)) : toMask;
+            pieceBitboard(undo.captured) |= capturedMask;
+            (pov ? occupiedBlack : occupiedWhite) |= capturedMask;
+        }
+
+        castlingRights = undo.castlingRights;
+        enPassantFile = undo.enPassantFile;
+        halfMoveCounter = undo.halfMoveCounter;
+        hash = undo.hash;
+
+        resetCachedAttack();
+    }
+
+    Bitboard::Undo Bitboard::applyNullMove() {
+        assert(!isCheck());
+        Undo undo{Move(), 0, false, castlingRights, enPassantFile, halfMoveCounter, hash};
+
+        if (enPassantFile.has_value()) hash ^= Zobrist::enPassant(enPassantFile.value());
+        enPassantFile = std::nullopt;
+        hash ^= Zobrist::side();
+        halfMoveCounter += 1;
+        moveCounter += pov ? 0 : 1;
+        pov = !pov;
+
+        resetCachedAttack();
+        assert(hash == computeHash());
+        return undo;
+    }
+
+    void Bitboard::unmakeNullMove(const Undo &undo) {
+        assert(undo.move == Move());
+        pov = !pov;
+        moveCounter -= pov ? 0 : 1;
+        enPassantFile = undo.enPassantFile;
+        halfMoveCounter = undo.halfMoveCounter;
+        hash = undo.hash;
+
+        resetCachedAttack();
+    }
+
+    char Bitboard::pieceAt(unsigned square) const {
+        uint64_t mask = 1ull << square;
+        if ((occupied() & mask) == 0) return 0;
+        if (pawns & mask) return 'p';
+        if (knights & mask) return 'n';
+        if (bishops & mask) return 'b';
+        if (rooks & mask) return 'r';
+        if (queens & mask) return 'q';
+        assert(kings & mask);
+        return 'k';
+    }
+
+    uint64_t &Bitboard::pieceBitboard(char piece) {
+        switch (piece) {
+            case 'p':
+                return pawns;
+            case 'n':
+                return knights;
+            case 'b':
+                return bishops;
+            case 'r':
+                return rooks;
+            case 'q':
+                return queens;
+            default:
+                assert(piece == 'k');
+                return kings;
+        }
+    }
+
+    uint64_t Bitboard::computeHash() const {
+        uint64_t result = 0;
+        for (uint64_t pieces = occupied(); pieces != 0; pieces &= pieces - 1) {
+            unsigned square = std::countr_zero(pieces);
+            result ^= Zobrist::piece((occupiedWhite >> square) & 1u, pieceAt(square), square);
+        }
+        result ^= Zobrist::castling(castlingRights);
+        if (enPassantFile.has_value()) result ^= Zobrist::enPassant(enPassantFile.value());
+        if (!pov) result ^= Zobrist::side();
+        return result;
+    }
+
+    Bitboard::Position Bitboard::position() const {
+        return {kings, queens, rooks, knights, bishops, pawns, occupiedWhite, occupiedBlack, castlingRights,
+                enPassantFile};
     }
 
     void Bitboard::preApplyPromotion(uint64_t fromMask, const Move &move) {
         // replace piece with promoted piece
         pawns &= ~fromMask;
-        assert(move.promotion.has_value());
+        assert(move.isPromotion());
 
-        switch (move.promotion.value()) {
+        switch (move.promotionPiece()) {
             case 'q':
                 queens |= fromMask;
                 break;
@@ -409,29 +556,32 @@ namespace chess {
         }
     }
 
-    void Bitboard::preApplyCastling(const Move &move) {
+    void Bitboard::moveCastlingRook(const Move &move) {
         // move rook to correct position
         unsigned rookOrigin = 0;
         unsigned rookTarget = 2;
-        if (move.toSquare == 5) {
+        if (move.toSquare() == 5) {
             rookOrigin = 7;
             rookTarget = 4;
-        } else if (move.toSquare == 57) {
+        } else if (move.toSquare() == 57) {
             rookOrigin = 56;
             rookTarget = 58;
-        } else if (move.toSquare == 61) {
+        } else if (move.toSquare() == 61) {
             rookOrigin = 63;
             rookTarget = 60;
         } else {
-            assert(move.toSquare == 1);
+            assert(move.toSquare() == 1);
         }
-        rooks &= ~(1ull << rookOrigin);
-        rooks |= 1ull << rookTarget;
+        uint64_t rookMoveMask = (1ull << rookOrigin) | (1ull << rookTarget);
+        rooks ^= rookMoveMask;
+        (pov ? occupiedWhite : occupiedBlack) ^= rookMoveMask;
+        hash ^= Zobrist::piece(pov, 'r', rookOrigin) ^ Zobrist::piece(pov, 'r', rookTarget);
 
     }
 
     void Bitboard::preApplyEnPassantCapture(unsigned int toSquare) {
         unsigned capturedPawnSquare = toSquare + (pov ? -8 : 8);
+        hash ^= Zobrist::piece(!pov, 'p', capturedPawnSquare);
         // remove pawn
         uint64_t capturedPawnMask = 1ull << capturedPawnSquare;
         pawns &= ~capturedPawnMask;
@@ -447,14 +597,14 @@ namespace chess {
     void Bitboard::preApplyRemoveCastlingRook(const Move &move) {
         unsigned rookSquares[] = {0, 7, 56, 63};
         for (int i = 0; i < 4; i++) {
-            if (move.toSquare == rookSquares[i] || move.fromSquare == rookSquares[i]) {
+            if (move.toSquare() == rookSquares[i] || move.fromSquare() == rookSquares[i]) {
                 castlingRights[i] = false;
             }
         }
     }
 
     void Bitboard::preApplyToggleEnPassant(const Move &move) {
-        uint64_t fromMask = 1ull << move.fromSquare;
+        uint64_t fromMask = 1ull << move.fromSquare();
         bool isPawn = fromMask & pawns;
         enPassantFile = std::nullopt;
         if (!isPawn || move.rankDistance() != 2) {
@@ -463,11 +613,11 @@ namespace chess {
         // set en passant
         // legality of en passant will be evaluated at a later time
         uint64_t enPassantRankMask = 0xffull << ((pov ? 3 : 4) * 8);
-        uint64_t pushedPawnMask = 1ull << move.toSquare;
+        uint64_t pushedPawnMask = 1ull << move.toSquare();
         uint64_t captureSquaresMask = ((pushedPawnMask << 1) | (pushedPawnMask >> 1)) & enPassantRankMask;
         bool enemyPawnOnRelevantSquare = captureSquaresMask & pawns & getOccupied(!pov);
         if (enemyPawnOnRelevantSquare) {
-            enPassantFile = move.toSquare % 8;
+            enPassantFile = move.toSquare() % 8;
         }
 
     }
@@ -577,17 +727,104 @@ namespace chess {
         return pinnedAny() & ~relevantPinMap(dx, dy);
     }
 
-    std::vector<Move> Bitboard::legalMoves() const {
-        if (legalMovesCache.has_value()) return legalMovesCache.value();
+    namespace {
+        /**
+         * Appends the generated moves to a list
+         */
+        struct ListSink {
+            MoveList &moves;
+
+            void addFrom(unsigned fromSquare, uint64_t toSquares) {
+                Bitboard::appendMovesFrom(moves, fromSquare, toSquares);
+            }
+
+            void addShifted(uint64_t movablePieces, int dx, int dy, uint64_t promotable = 0) {
+                Bitboard::appendMoves(moves, movablePieces, dx, dy, promotable);
+            }
+
+            static constexpr bool done() { return false; }
+        };
+
+        /**
+         * Counts the generated moves by the population count of their masks, a promotion counts once per piece
+         */
+        struct CountSink {
+            unsigned count = 0;
+
+            // the masks are sparse, clearing bits beats std::popcount unless the target has a popcnt instruction
+            static unsigned bitCount(uint64_t mask) {
+                unsigned result = 0;
+                for (; mask != 0; mask &= mask - 1) result++;
+                return result;
+            }
+
+            void addFrom(unsigned, uint64_t toSquares) { count += bitCount(toSquares); }
+
+            void addShifted(uint64_t movablePieces, int, int, uint64_t promotable = 0) {
+                count += bitCount(movablePieces) + 3 * bitCount(movablePieces & promotable);
+            }
+
+            static constexpr bool done() { return false; }
+        };
+
+        /**
+         * Only notes whether any move was generated, the generators stop early once it is done
+         */
+        struct AnySink {
+            bool found = false;
+
+            void addFrom(unsigned, uint64_t toSquares) { found |= toSquares != 0; }
+
+            void addShifted(uint64_t movablePieces, int, int, uint64_t = 0) { found |= movablePieces != 0; }
+
+            [[nodiscard]] bool done() const { return found; }
+        };
+    }
+
+    MoveList Bitboard::legalMoves() const {
+        MoveList result;
+        ListSink sink{result};
+        generateLegalMoves(sink);
+        return result;
+    }
+
+    unsigned Bitboard::countLegalMoves() const {
+        CountSink sink;
+        generateLegalMoves(sink);
+        return sink.count;
+    }
+
+    bool Bitboard::hasLegalMove() const {
         evalAttack();
         assert(cachedAttack);
 
-        std::vector<Move> result;
+        AnySink sink;
+        kingMoves(sink);
+        if (sink.found || std::popcount(checks) >= 2) return sink.found;
+
+        uint64_t targets = ~0ull;
+        if (std::popcount(checks) == 1) {
+            targets = getCheckBlockCaptureSquares();
+        }
+        // cheapest generators first, castling needs no test: if it is legal, so is the king's first step
+        knightMoves(sink, targets);
+        if (sink.found) return true;
+        pawnMoves(sink, targets);
+        if (sink.found) return true;
+        queenLikeMoves(sink, targets);
+        return sink.found;
+    }
+
+    template<typename Sink>
+    void Bitboard::generateLegalMoves(Sink &sink) const {
+        evalAttack();
+        assert(cachedAttack);
 
         // multiple checks
         if (std::popcount(checks) >= 2) {
-            // step king
-            kingMoves(result);
+            // only the king can step out of a double check
+            kingMoves(sink);
+            return;
         }
 
         uint64_t targets = ~0ull;
@@ -597,33 +834,56 @@ namespace chess {
             targets = getCheckBlockCaptureSquares();
         }
 
-        kingMoves(result);
-        queenLikeMoves(result, targets);
-        knightMoves(result, targets);
-        pawnMoves(result, targets);
-        castlingMoves(result);
+        kingMoves(sink);
+        queenLikeMoves(sink, targets);
+        knightMoves(sink, targets);
+        pawnMoves(sink, targets);
+        castlingMoves(sink);
+    }
+
+    MoveList Bitboard::captureMoves() const {
+        evalAttack();
+        assert(cachedAttack);
+
+        MoveList result;
+        ListSink sink{result};
+        uint64_t captures = getOccupied(!pov);
+
+        if (std::popcount(checks) >= 2) {
+            kingMoves(sink, captures);
+            return result;
+        }
+
+        uint64_t targets = ~0ull;
+        if (std::popcount(checks) == 1) {
+            targets = getCheckBlockCaptureSquares();
+        }
+
+        kingMoves(sink, captures);
+        queenLikeMoves(sink, targets & captures);
+        knightMoves(sink, targets & captures);
+        // pawns need the unrestricted targets for en passant and promotion pushes
+        pawnMoves(sink, targets, true);
 
-        legalMovesCache = result;
         return result;
     }
 
     /**
      * Computes all legal king moves, excluding castling
-     * @param result vector to which the moves are appended to
+     * @param sink receives the moves
+     * @param targetSquares bitboard denoting to which squares the move must go to
      */
-    void Bitboard::kingMoves(std::vector<Move> &result) const {
+    template<typename Sink>
+    void Bitboard::kingMoves(Sink &sink, uint64_t targetSquares) const {
         uint64_t ownKing = kings & getOccupied(pov);
         assert(std::popcount(ownKing) == 1);
         uint8_t kingpos = std::countr_zero(ownKing);
 
-        for (int dx : {-1, 0, 1}) {
-            for (int dy : {-1, 0, 1}) {
-                if (dx == 0 && dy == 0) continue;
-                if ((ownKing & canMoveToMask(dx, dy)) == 0) continue;
-                if ((applyOffset(dx, dy, ownKing) & ~controlled & ~getOccupied(pov)) == 0) continue;
-                result.emplace_back(kingpos, kingpos + dx + 8 * dy);
-            }
-        }
+        uint64_t freeSquares = ~controlled & ~getOccupied(pov) & targetSquares;
+        forEachKingOffset([&]<Offset offset>() {
+            if ((ownKing & canMoveToMask<offset.left, offset.up>()) == 0) return;
+            sink.addFrom(kingpos, applyOffset<offset.left, offset.up>(ownKing) & freeSquares);
+        });
     }
 
     /**
@@ -635,119 +895,126 @@ namespace chess {
         // knights and pawn attacks cannot be blocked
         if ((knights | pawns) & checks) return checks;
 
-        uint8_t kingPos = std::countr_zero(kings & getOccupied(pov));
-        uint8_t checkPos = std::countr_zero(checks);
-
-        Move attack(checkPos, kingPos);
-        int length = std::max(attack.fileDistance(), attack.rankDistance());
-
-        int dx = (attack.toSquare % 8 < attack.fromSquare % 8 ? -1 : 1) * std::min(1u, attack.fileDistance());
-        int dy = (attack.toSquare / 8 < attack.fromSquare / 8 ? -1 : 1) * std::min(1u, attack.rankDistance());
-
-        uint64_t retval = checks;
-        for (int i = 1; i < length; i++) {
-            retval |= applyOffset(dx * i, dy * i, checks);
-        }
-        return retval;
+        unsigned kingPos = std::countr_zero(kings & getOccupied(pov));
+        unsigned checkPos = std::countr_zero(checks);
+        return checks | Attacks::between(kingPos, checkPos);
     }
 
     /**
      * Returns legal moves from queen like pieces (queen, rook, bishop)
-     * @param result vector to which the moves are appended to
+     * @param sink receives the moves
      * @param targetSquares bitboard denoting to which squares the move must go to
      */
-    void Bitboard::queenLikeMoves(std::vector<Move> &result, uint64_t targetSquares) const {
-        for (int dx : {-1, 0, 1}) {
-            for (int dy : {-1, 0, 1}) {
-                if (dx == 0 && dy == 0) continue;
-                queenLikeMovesSingleRay(result, targetSquares, dx, dy);
-            }
+    template<typename Sink>
+    void Bitboard::queenLikeMoves(Sink &sink, uint64_t targetSquares) const {
+        uint64_t rookLike = (queens | rooks) & getOccupied(pov);
+        uint64_t bishopLike = (queens | bishops) & getOccupied(pov);
+        uint64_t pinned = pinnedAny();
+        unsigned kingSquare = std::countr_zero(kings & getOccupied(pov));
+        targetSquares &= ~getOccupied(pov);
+
+        for (uint64_t pieces = rookLike | bishopLike; pieces != 0 && !sink.done(); pieces &= pieces - 1) {
+            unsigned square = std::countr_zero(pieces);
+            uint64_t pieceMask = 1ull << square;
+            uint64_t attacks = 0;
+            if (rookLike & pieceMask) attacks |= Attacks::rook(square, occupied());
+            if (bishopLike & pieceMask) attacks |= Attacks::bishop(square, occupied());
+            attacks &= targetSquares;
+            // pinned pieces may only move along the pinning ray
+            if (pinned & pieceMask) attacks &= Attacks::line(kingSquare, square);
+            sink.addFrom(square, attacks);
         }
-
     }
 
-    void Bitboard::queenLikeMovesSingleRay(std::vector<Move> &result, uint64_t targetSquares, int dx, int dy) const {
-        uint64_t relevantPieces = (queens | (dx == 0 || dy == 0 ? rooks : bishops)) & getOccupied(pov);
-        uint64_t unpinnedPieces = relevantPieces & ~pinnedForDirection(dx, dy);
-        uint64_t lastFree = unpinnedPieces;
-        for (int dist = 1; dist < 8; dist++) {
-            uint64_t movablePieces = lastFree & canMoveToMask(dx * dist, dy * dist) &
-                                     applyOffset(-dx * dist, -dy * dist, ~getOccupied(pov) & targetSquares);
-            appendMoves(result, movablePieces, dx * dist, dy * dist);
-            lastFree &= applyOffset(-dx * dist, -dy * dist, ~occupied());
-        }
-    }
-
-    void Bitboard::knightMoves(std::vector<Move> &result, uint64_t targetSquares) const {
-        int dxArray[] = {-2, -2, -1, -1, 1, 1, 2, 2};
-        int dyArray[] = {-1, 1, -2, 2, -2, 2, -1, 1};
+    template<typename Sink>
+    void Bitboard::knightMoves(Sink &sink, uint64_t targetSquares) const {
         uint64_t relevantPieces = knights & getOccupied(pov) & ~pinnedAny();
+        uint64_t freeSquares = ~getOccupied(pov) & targetSquares;
 
-        for (unsigned idx = 0; idx < 8; idx++) {
-            int dx = dxArray[idx];
-            int dy = dyArray[idx];
-            uint64_t movablePieces =
-                    relevantPieces & canMoveToMask(dx, dy) & applyOffset(-dx, -dy, ~getOccupied(pov) & targetSquares);
-            appendMoves(result, movablePieces, dx, dy);
-        }
+        forEachKnightOffset([&]<Offset offset>() {
+            uint64_t movablePieces = relevantPieces & canMoveToMask<offset.left, offset.up>() &
+                                     applyOffset<-offset.left, -offset.up>(freeSquares);
+            sink.addShifted(movablePieces, offset.left, offset.up);
+        });
     }
 
-    void Bitboard::pawnMoves(std::vector<Move> &result, uint64_t targetSquares) const {
+    /**
+     * @param capturesOnly only generate captures and promotions
+     */
+    template<typename Sink>
+    void Bitboard::pawnMoves(Sink &sink, uint64_t targetSquares, bool capturesOnly) const {
+        if (pov) pawnMoves<true>(sink, targetSquares, capturesOnly);
+        else pawnMoves<false>(sink, targetSquares, capturesOnly);
+    }
 
-        uint64_t promotableRank = pov ? 0xffull << 8u * 6u : 0xff00ull;
-        uint64_t startingRank = !pov ? 0xffull << 8u * 6u : 0xff00ull;
-        uint64_t ownPawns = pawns & getOccupied(pov);
-        int dy = pov ? 1 : -1;
+    template<bool white, typename Sink>
+    void Bitboard::pawnMoves(Sink &sink, uint64_t targetSquares, bool capturesOnly) const {
+        constexpr uint64_t promotableRank = white ? 0xffull << 8u * 6u : 0xff00ull;
+        constexpr uint64_t startingRank = !white ? 0xffull << 8u * 6u : 0xff00ull;
+        constexpr int dy = white ? 1 : -1;
+        uint64_t ownPawns = pawns & getOccupied(white);
 
-        uint64_t pushable = ownPawns & ~pinnedForDirection(0, dy) & applyOffset(0, -dy, ~occupied());
+        uint64_t pushable = ownPawns & ~pinnedForDirection(0, dy) & applyOffset<0, -dy>(~occupied());
 
         // regular push
-        uint64_t movablePieces = pushable & applyOffset(0, -dy, targetSquares);
-        appendMoves(result, movablePieces, 0, dy, promotableRank);
+        uint64_t movablePieces = pushable & applyOffset<0, -dy>(targetSquares);
+        if (capturesOnly) movablePieces &= promotableRank;
+        sink.addShifted(movablePieces, 0, dy, promotableRank);
 
         // double push
-        movablePieces = pushable & startingRank & applyOffset(0, -2 * dy, ~occupied() & targetSquares);
-        appendMoves(result, movablePieces, 0, 2 * dy);
+        if (!capturesOnly) {
+            movablePieces = pushable & startingRank & applyOffset<0, -2 * dy>(~occupied() & targetSquares);
+            sink.addShifted(movablePieces, 0, 2 * dy);
+        }
 
         // capture
-        uint64_t capturable = getOccupied(!pov) & targetSquares;
-        if (enPassantFile.has_value())
-            capturable |= 1ull << (enPassantFile.value() + (pov ? 5 : 2) * 8);
-        for (int dx : {-1, 1}) {
-            movablePieces = ownPawns & ~pinnedForDirection(dx, dy) & applyOffset(-dx, -dy, capturable) &
-                            canMoveToMask(dx, dy);
-            appendMoves(result, movablePieces, dx, dy, promotableRank);
+        uint64_t capturable = getOccupied(!white) & targetSquares;
+        if (enPassantFile.has_value()) {
+            uint64_t enPassantSquare = 1ull << (enPassantFile.value() + (white ? 5 : 2) * 8);
+            uint64_t enPassantPawn = 1ull << (enPassantFile.value() + (white ? 4 : 3) * 8);
+            // under check en passant is only legal if it blocks or removes the checking pawn
+            if ((enPassantSquare | enPassantPawn) & targetSquares)
+                capturable |= enPassantSquare;
         }
+        forEachOffset<Offset{-1, dy}, Offset{1, dy}>([&]<Offset offset>() {
+            uint64_t capturing = ownPawns & ~pinnedForDirection(offset.left, offset.up) &
+                                 applyOffset<-offset.left, -offset.up>(capturable) &
+                                 canMoveToMask<offset.left, offset.up>();
+            sink.addShifted(capturing, offset.left, offset.up, promotableRank);
+        });
+    }
+
+    template<typename Sink>
+    void Bitboard::castlingMoves(Sink &sink) const {
+        if (pov) castlingMoves<true>(sink);
+        else castlingMoves<false>(sink);
     }
 
-    void Bitboard::castlingMoves(std::vector<Move> &result) const {
+    template<bool white, typename Sink>
+    void Bitboard::castlingMoves(Sink &sink) const {
         if (checks != 0) return;
-        bool kingsideRights = castlingRights[pov ? 0 : 2];
-        bool queensideRights = castlingRights[pov ? 1 : 3];
-        unsigned rankShift = (pov ? 0 : 7);
-        uint64_t queensideBetween = 0b01110000ull << rankShift;
-        uint64_t kingsideBetween = 0b00000110ull << rankShift;
-        uint64_t queensideTraversed = 0b00110000ull << rankShift;
-        uint64_t kingsideTraversed = kingsideBetween;
-        uint64_t ownKing = kings & getOccupied(pov);
+        bool kingsideRights = castlingRights[white ? 0 : 2];
+        bool queensideRights = castlingRights[white ? 1 : 3];
+        constexpr unsigned rankShift = (white ? 0 : 7 * 8);
+        constexpr uint64_t queensideBetween = 0b01110000ull << rankShift;
+        constexpr uint64_t kingsideBetween = 0b00000110ull << rankShift;
+        constexpr uint64_t queensideTraversed = 0b00110000ull << rankShift;
+        constexpr uint64_t kingsideTraversed = kingsideBetween;
+        uint64_t ownKing = kings & getOccupied(white);
 
         if (kingsideRights && (kingsideBetween & occupied()) == 0 && (kingsideTraversed & controlled) == 0)
-            appendMoves(result, ownKing, -2, 0);
+            sink.addShifted(ownKing, -2, 0);
         if (queensideRights && (queensideBetween & occupied()) == 0 && (queensideTraversed & controlled) == 0)
-            appendMoves(result, ownKing, 2, 0);
+            sink.addShifted(ownKing, 2, 0);
 
     }
 
-    void Bitboard::appendMoves(std::vector<Move> &result, uint64_t movablePieces, int dx, int dy, uint64_t promotable) {
+    void Bitboard::appendMoves(MoveList &result, uint64_t movablePieces, int dx, int dy, uint64_t promotable) {
         promotable &= movablePieces;
-        if (movablePieces == 0) return;
         int8_t offset = dx + 8 * dy;
-        uint8_t idx = 0;
         while (movablePieces != 0) {
-            uint8_t trailingZeros = std::countr_zero(movablePieces);
-            uint8_t trailingZerosPromotable = std::countr_zero(promotable);
-            idx += trailingZeros;
-            if (trailingZeros != trailingZerosPromotable) {
+            uint8_t idx = std::countr_zero(movablePieces);
+            if ((promotable & (1ull << idx)) == 0) {
                 result.emplace_back(idx, idx + offset);
             } else {
                 result.emplace_back(idx, idx + offset, 'q');
@@ -755,14 +1022,19 @@ namespace chess {
                 result.emplace_back(idx, idx + offset, 'b');
                 result.emplace_back(idx, idx + offset, 'n');
             }
-            idx++;
-            movablePieces >>= trailingZeros + 1;
-            promotable >>= trailingZeros + 1;
+            // clear lowest set bit
+            movablePieces &= movablePieces - 1;
+        }
+    }
+
+    void Bitboard::appendMovesFrom(MoveList &result, unsigned fromSquare, uint64_t toSquares) {
+        for (; toSquares != 0; toSquares &= toSquares - 1) {
+            result.emplace_back(fromSquare, std::countr_zero(toSquares));
         }
     }
 
     bool Bitboard::isGameOver() const {
-        return legalMoves().empty() | isDraw50() | isDrawInsufficient();
+        return !hasLegalMove() | isDraw50() | isDrawInsufficient();
     }
 
     bool Bitboard::isCheck() const {
@@ -4,10 +4,10 @@
 #include <string>
 #include <string_view>
 #include <bitset>
-#include <vector>
 #include <cstring>
 #include <stdexcept>
 #include "Move.hpp"
+#include "MoveList.hpp"
 
 namespace chess {
     class Bitboard {
@@ -29,6 +29,9 @@ namespace chess {
         unsigned moveCounter;
         unsigned halfMoveCounter;
 
+        // Zobrist key of the position, updated incrementally
+        uint64_t hash;
+
         mutable uint64_t controlled;
         mutable uint64_t pinnedHorizontal;
         mutable uint64_t pinnedVertical;
@@ -38,14 +41,13 @@ namespace chess {
         mutable uint64_t checks;
         mutable bool cachedAttack;
 
-        mutable std::optional<std::vector<Move>> legalMovesCache;
-
     private:
         void evalPawnAttack() const;
 
-        void evalQueenLikeAttack() const;
+        template<bool white>
+        void evalPawnAttack() const;
 
-        void evalQueenLikeAttackXray(int dleft, int dup) const;
+        void evalQueenLikeAttack() const;
 
         void evalKingAttack() const;
 
@@ -53,6 +55,9 @@ namespace chess {
 
         void evalEnPassantPin() const;
 
+        template<bool white>
+        void evalEnPassantPin() const;
+
         uint64_t &relevantPinMap(int dx, int dy) const;
         uint64_t pinnedAny() const;
         uint64_t pinnedForDirection(int dx, int dy) const;
@@ -89,6 +94,13 @@ namespace chess {
 
         unsigned int getHalfMoveCounter() const { return halfMoveCounter; };
 
+        [[nodiscard]] uint64_t getHash() const { return hash; };
+
+        /**
+         * Computes the Zobrist key from scratch, getHash() must always match it
+         */
+        [[nodiscard]] uint64_t computeHash() const;
+
         uint64_t getPinnedHorizontal() const { return pinnedHorizontal; };
 
         uint64_t getPinnedVertical() const { return pinnedVertical; };
@@ -107,21 +119,53 @@ namespace chess {
 
         void parseFEN(std::string_view fen);
 
-        std::vector<Move> legalMoves() const;
+        MoveList legalMoves() const;
+
+        /**
+         * Generates the subset of legalMoves() that captures a piece (including en passant) or promotes a pawn
+         */
+        MoveList captureMoves() const;
+
+        /**
+         * @return true if the side to move has a legal move, stops at the first one found
+         */
+        [[nodiscard]] bool hasLegalMove() const;
+
+        /**
+         * Counts legalMoves() from the target masks without building the list
+         */
+        [[nodiscard]] unsigned countLegalMoves() const;
 
     private:
-        void kingMoves(std::vector<Move> &result) const;
+        /**
+         * The generators hand their moves to a sink, which appends, counts or only notes that a move exists.
+         * A sink provides addFrom(fromSquare, toSquares), addShifted(movablePieces, dx, dy, promotable) and done().
+         */
+        template<typename Sink>
+        void generateLegalMoves(Sink &sink) const;
+
+        template<typename Sink>
+        void kingMoves(Sink &sink, uint64_t targetSquares = ~0ull) const;
 
         uint64_t getCheckBlockCaptureSquares() const;
 
-        void queenLikeMoves(std::vector<Move> &result, uint64_t targetSquares) const;
-        void queenLikeMovesSingleRay(std::vector<Move> &result, uint64_t targetSquares, int dx, int dy) const;
+        template<typename Sink>
+        void queenLikeMoves(Sink &sink, uint64_t targetSquares) const;
+
+        template<typename Sink>
+        void knightMoves(Sink &sink, uint64_t targetSquares) const;
+
+        template<typename Sink>
+        void pawnMoves(Sink &sink, uint64_t targetSquares, bool capturesOnly = false) const;
 
-        void knightMoves(std::vector<Move> &result, uint64_t targetSquares) const;
+        template<bool white, typename Sink>
+        void pawnMoves(Sink &sink, uint64_t targetSquares, bool capturesOnly) const;
 
-        void pawnMoves(std::vector<Move> &result, uint64_t targetSquares) const;
+        template<typename Sink>
+        void castlingMoves(Sink &sink) const;
 
-        void castlingMoves(std::vector<Move> &result) const;
+        template<bool white, typename Sink>
+        void castlingMoves(Sink &sink) const;
 
     private:
         void parseBoardFEN(std::string_view boardFen);
@@ -134,20 +178,70 @@ namespace chess {
 
         void parseHalfMoveFEN(std::string_view halfMoveFen);
 
+        void parseFullMoveFEN(std::string_view fullMoveFen);
+
     public:
         std::string to_fen() const;
 
         [[nodiscard]] std::string to_string() const;
 
 
-        void applyMoveSelf(const Move &move);
+        /**
+         * Everything needed to take back a move with unmakeMove
+         */
+        struct Undo {
+            Move move;
+            // captured piece as lower case character or 0
+            char captured;
+            bool enPassant;
+            std::bitset<4> castlingRights;
+            std::optional<unsigned> enPassantFile;
+            unsigned halfMoveCounter;
+            uint64_t hash;
+        };
+
+        /**
+         * Piece placement, castling rights and en passant file, i.e. everything compared by operator==
+         */
+        struct Position {
+            uint64_t kings;
+            uint64_t queens;
+            uint64_t rooks;
+            uint64_t knights;
+            uint64_t bishops;
+            uint64_t pawns;
+            uint64_t occupiedWhite;
+            uint64_t occupiedBlack;
+            std::bitset<4> castlingRights;
+            std::optional<unsigned> enPassantFile;
+
+            bool operator==(const Position &other) const = default;
+        };
+
+        Undo applyMoveSelf(const Move &move);
+
+        /**
+         * Takes back the move the undo record was created for. Must be called in reverse order of applyMoveSelf.
+         */
+        void unmakeMove(const Undo &undo);
+
+        /**
+         * Passes the turn to the opponent without moving a piece. Must not be used while in check.
+         * The en passant file is cleared, the undo record holds Move() as move.
+         */
+        Undo applyNullMove();
+
+        /**
+         * Takes back a null move created by applyNullMove
+         */
+        void unmakeNullMove(const Undo &undo);
 
         Bitboard applyMoveCopy(const Move &move) const;
 
     private:
         void preApplyPromotion(uint64_t fromMask, const Move &move);
 
-        void preApplyCastling(const Move &move);
+        void moveCastlingRook(const Move &move);
 
         void preApplyToggleEnPassant(const Move &move);
 
@@ -159,16 +253,49 @@ namespace chess {
 
         void movePiece(unsigned fromSquare, unsigned toSquare);
 
+        uint64_t &pieceBitboard(char piece);
+
         void evalEnPassantLegality();
 
     public:
         bool operator==(const Bitboard &other) const;
 
+        [[nodiscard]] Position position() const;
+
+        /**
+         * @return piece on the square as lower case character or 0 if the square is empty
+         */
+        [[nodiscard]] char pieceAt(unsigned square) const;
+
         static constexpr uint64_t canMoveToMask(int left, int up);
 
         static constexpr uint64_t applyOffset(int left, int up, uint64_t board);
 
-        static void appendMoves(std::vector<Move>& result, uint64_t movablePieces, int dx, int dy, uint64_t promotable = 0);
+        /**
+         * canMoveToMask(left, up) for an offset known at compile time
+         */
+        template<int left, int up>
+        static constexpr uint64_t canMoveToMask() {
+            static_assert(left > -8 && left < 8 && up > -8 && up < 8 && (left != 0 || up != 0));
+            constexpr uint8_t rowMask = left >= 0 ? 0xffu >> left : static_cast<uint8_t>(0xffu << -left);
+            constexpr uint64_t mask = rowMask * 0x0101010101010101ull;
+            return up >= 0 ? mask >> 8 * up : mask << 8 * -up;
+        }
+
+        /**
+         * applyOffset(left, up, board) for an offset known at compile time, compiles to a single shift
+         */
+        template<int left, int up>
+        static constexpr uint64_t applyOffset(uint64_t board) {
+            static_assert(left > -8 && left < 8 && up > -8 && up < 8 && (left != 0 || up != 0));
+            constexpr int offset = left + 8 * up;
+            if constexpr (offset > 0) return board << offset;
+            else return board >> -offset;
+        }
+
+        static void appendMoves(MoveList& result, uint64_t movablePieces, int dx, int dy, uint64_t promotable = 0);
+
+        static void appendMovesFrom(MoveList& result, unsigned fromSquare, uint64_t toSquares);
 
         bool isGameOver() const;
 
@@ -1,10 +1,23 @@
 #pragma once
 
+#include <cstdint>
+
 namespace chess {
+/**
+ * Limits of a single search as sent with the UCI go command. Zero means the limit was not given.
+ */
 struct Clock {
     int white_time_ms;
     int black_time_ms;
     int white_increment_ms;
     int black_increment_ms;
+    int moves_to_go = 0;
+    int move_time_ms = 0;
+    unsigned depth = 0;
+    uint64_t nodes = 0;
+    // search until stopped, all other limits are ignored
+    bool infinite = false;
+    // search on the opponent's time, the time limits only start to count with ponderhit
+    bool ponder = false;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+#include "Move.hpp"
+#include "Zobrist.hpp"
+
+namespace chess {
+    namespace internal {
+        constexpr std::size_t cuckooSize = 8192;
+
+        constexpr std::size_t cuckooFirstSlot(uint64_t key) { return key & (cuckooSize - 1); }
+
+        constexpr std::size_t cuckooSecondSlot(uint64_t key) { return (key >> 16u) & (cuckooSize - 1); }
+
+        struct CuckooTables {
+            std::array<uint64_t, cuckooSize> keys{};
+            std::array<Move, cuckooSize> moves{};
+            unsigned count = 0;
+        };
+
+        /**
+         * @return true if the piece can move between both squares on an empty board
+         */
+        constexpr bool canReach(char piece, unsigned from, unsigned to) {
+            int dx = static_cast<int>(to % 8) - static_cast<int>(from % 8);
+            int dy = static_cast<int>(to / 8) - static_cast<int>(from / 8);
+            dx = dx < 0 ? -dx : dx;
+            dy = dy < 0 ? -dy : dy;
+            bool straight = dx == 0 || dy == 0;
+            bool diagonal = dx == dy;
+            switch (piece) {
+                case 'n':
+                    return (dx == 1 && dy == 2) || (dx == 2 && dy == 1);
+                case 'b':
+                    return diagonal;
+                case 'r':
+                    return straight;
+                case 'q':
+                    return straight || diagonal;
+                default:
+                    return dx <= 1 && dy <= 1;
+            }
+        }
+
+        /**
+         * Every non-pawn move between two squares is stored once under the key difference it causes, both
+         * directions share the entry. Cuckoo hashing keeps each key in one of its two slots.
+         */
+        constexpr CuckooTables generateCuckooTables() {
+            CuckooTables tables;
+            for (bool color : {false, true}) {
+                for (char piece : {'n', 'b', 'r', 'q', 'k'}) {
+                    for (unsigned from = 0; from < 64; from++) {
+                        for (unsigned to = from + 1; to < 64; to++) {
+                            if (!canReach(piece, from, to)) continue;
+                            uint64_t key = Zobrist::piece(color, piece, from) ^ Zobrist::piece(color, piece, to)
+                                           ^ Zobrist::side();
+                            Move move(from, to);
+                            std::size_t slot = cuckooFirstSlot(key);
+                            // insert and move the displaced entry to its other slot until an empty slot is hit
+                            while (true) {
+                                std::swap(tables.keys[slot], key);
+                                std::swap(tables.moves[slot], move);
+                                if (move == Move()) break;
+                                slot = slot == cuckooFirstSlot(key) ? cuckooSecondSlot(key) : cuckooFirstSlot(key);
+                            }
+                            tables.count++;
+                        }
+                    }
+                }
+            }
+            return tables;
+        }
+
+        inline constexpr auto cuckooTables = generateCuckooTables();
+    }
+
+    /**
+     * Key differences of all reversible moves, used to detect that the side to move can repeat a position with
+     * a single move (Marcel van Kervinck's cuckoo hashing of Zobrist move keys).
+     */
+    class Cuckoo {
+    public:
+        // moves of knights, bishops, rooks, queens and kings between two squares for both colors
+        static constexpr unsigned moveCount = 3668;
+
+        /**
+         * @param moveKey Zobrist key difference of two positions, including the side to move
+         * @return the move causing the difference in either direction or Move() if no single move does
+         */
+        static constexpr Move find(uint64_t moveKey) {
+            std::size_t slot = internal::cuckooFirstSlot(moveKey);
+            if (internal::cuckooTables.keys[slot] == moveKey) return internal::cuckooTables.moves[slot];
+            slot = internal::cuckooSecondSlot(moveKey);
+            if (internal::cuckooTables.keys[slot] == moveKey) return internal::cuckooTables.moves[slot];
+            return Move();
+        }
+    };
+
+    static_assert(internal::cuckooTables.count == Cuckoo::moveCount);
+}
@@ -1,7 +1,6 @@
 #include "Move.hpp"
 
 #include <cassert>
-#include <functional>
 
 namespace chess {
 namespace internal {
@@ -25,7 +24,24 @@ unsigned indexFromRowChar(char row) {
   assert(row <= '8');
   return row - '1';
 }
+
+constexpr char promotionPieces[] = {0, 'n', 'b', 'r', 'q'};
+
+unsigned promotionIndex(char promotion) {
+  switch (promotion) {
+    case 'n': return 1;
+    case 'b': return 2;
+    case 'r': return 3;
+    case 'q': return 4;
+    default:
+      assert(false);
+      return 0;
+  }
 }
+}
+
+Move::Move(unsigned fromSquare, unsigned toSquare, char promotion)
+    : data(fromSquare | toSquare << toShift | internal::promotionIndex(promotion) << promotionShift) {}
 
 Move::Move(std::string_view uci) {
   assert(uci.length() == 4 or uci.length() == 5);
@@ -34,53 +50,51 @@ Move::Move(std::string_view uci) {
   char toFile = uci[2];
   char toRow = uci[3];
 
-  fromSquare =       internal::indexFromFileChar(fromFile)
-               + 8 * internal::indexFromRowChar(fromRow);
+  unsigned fromSquare =       internal::indexFromFileChar(fromFile)
+                        + 8 * internal::indexFromRowChar(fromRow);
 
-  toSquare =       internal::indexFromFileChar(toFile)
-             + 8 * internal::indexFromRowChar(toRow);
+  unsigned toSquare =       internal::indexFromFileChar(toFile)
+                      + 8 * internal::indexFromRowChar(toRow);
 
+  data = fromSquare | toSquare << toShift;
   if (uci.length() == 5) {
-    promotion = uci[4];
+    data |= internal::promotionIndex(uci[4]) << promotionShift;
   }
 }
 
+char Move::promotionPiece() const {
+  return internal::promotionPieces[data >> promotionShift];
+}
+
+std::optional<char> Move::promotion() const {
+  if (!isPromotion()) return std::nullopt;
+  return promotionPiece();
+}
+
 std::string Move::toUCI() const {
-  return {
-      internal::fileCharFromSquare(fromSquare),
-      internal::rowCharFromSquare(fromSquare),
-      internal::fileCharFromSquare(toSquare),
-      internal::rowCharFromSquare(toSquare)
+  std::string uci = {
+      internal::fileCharFromSquare(fromSquare()),
+      internal::rowCharFromSquare(fromSquare()),
+      internal::fileCharFromSquare(toSquare()),
+      internal::rowCharFromSquare(toSquare())
   };
+  if (isPromotion()) {
+    uci += promotionPiece();
+  }
+  return uci;
 }
 
     unsigned Move::fileDistance() const {
-        auto fromFile = fromSquare%8;
-        auto toFile = toSquare%8;
+        auto fromFile = fromSquare()%8;
+        auto toFile = toSquare()%8;
 
         return fromFile > toFile ? fromFile-toFile : toFile - fromFile;
     }
 
     unsigned Move::rankDistance() const {
-        auto fromRow = fromSquare/8;
-        auto toRow = toSquare/8;
+        auto fromRow = fromSquare()/8;
+        auto toRow = toSquare()/8;
 
         return fromRow > toRow ? fromRow - toRow : toRow - fromRow;
     }
-
-    bool operator== (const Move& lhs, const Move& rhs) {
-  return lhs.promotion == rhs.promotion
-    && lhs.fromSquare == rhs.fromSquare
-    && lhs.toSquare == rhs.toSquare;
-}
-
-size_t HashMove::operator()(const Move& move) const {
-  auto uHasher = std::hash<uint64_t>();
-  auto oHasher = std::hash<std::optional<char>>();
-  auto hashValue = uHasher(move.toSquare);
-  hashValue ^= uHasher(move.fromSquare) + 0x9e3779b9 + (hashValue<<6) + (hashValue>>2);
-  hashValue ^= oHasher(move.promotion)  + 0x9e3779b9 + (hashValue<<6) + (hashValue>>2);
-
-  return hashValue;
 }
-}
\ No newline at end of file
@@ -6,24 +6,49 @@
 #include <string_view>
 
 namespace chess {
+/**
+ * Move packed into 16 bits: from square (bits 0-5), to square (bits 6-11) and promotion piece (bits 12-14).
+ * Castling and en passant are not flagged, they follow unambiguously from the position the move is applied to
+ * and moves parsed from UCI compare equal to generated ones.
+ */
 class Move {
-public:
-  unsigned fromSquare;
-  unsigned toSquare;
-  std::optional<char> promotion;
+private:
+  uint16_t data;
+
+  static constexpr unsigned toShift = 6;
+  static constexpr unsigned promotionShift = 12;
+  static constexpr uint16_t squareMask = 0x3f;
 
 public:
-  Move(unsigned fromSquare, unsigned toSquare) : fromSquare(fromSquare), toSquare(toSquare) {};
-  Move(unsigned fromSquare, unsigned toSquare, char promotion) : fromSquare(fromSquare), toSquare(toSquare), promotion(promotion) {};
+  Move() = default;
+  constexpr Move(unsigned fromSquare, unsigned toSquare) : data(fromSquare | toSquare << toShift) {};
+  Move(unsigned fromSquare, unsigned toSquare, char promotion);
   explicit Move(std::string_view uci);
   [[nodiscard]] std::string toUCI() const;
   [[nodiscard]] unsigned fileDistance() const;
   [[nodiscard]] unsigned rankDistance() const;
+
+  [[nodiscard]] constexpr unsigned fromSquare() const { return data & squareMask; }
+  [[nodiscard]] constexpr unsigned toSquare() const { return (data >> toShift) & squareMask; }
+  [[nodiscard]] constexpr bool isPromotion() const { return (data >> promotionShift) != 0; }
+  /**
+   * @return promotion piece as lower case character ('q', 'r', 'b', 'n') or 0 if the move is no promotion
+   */
+  [[nodiscard]] char promotionPiece() const;
+  [[nodiscard]] std::optional<char> promotion() const;
+  [[nodiscard]] constexpr uint16_t raw() const { return data; }
+  static constexpr Move fromRaw(uint16_t raw) {
+    Move move;
+    move.data = raw;
+    return move;
+  }
+
+  friend constexpr bool operator== (Move lhs, Move rhs) { return lhs.data == rhs.data; }
 };
 
-bool operator== (const Move&, const Move&);
+static_assert(sizeof(Move) == 2);
 
 struct HashMove {
-  size_t operator() (const Move&) const;
+  size_t operator() (const Move& move) const { return move.raw(); }
 };
 }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "Move.hpp"
+
+namespace chess {
+    /**
+     * Fixed capacity list of moves that lives on the stack, so generating moves never allocates.
+     * No legal chess position has more than 218 moves.
+     */
+    class MoveList {
+    public:
+        static constexpr std::size_t capacity = 256;
+
+    private:
+        std::array<Move, capacity> moves;
+        std::size_t count = 0;
+
+    public:
+        template<typename... Args>
+        void emplace_back(Args &&... args) {
+            assert(count < capacity);
+            moves[count++] = Move(std::forward<Args>(args)...);
+        }
+
+        void push_back(const Move &move) {
+            assert(count < capacity);
+            moves[count++] = move;
+        }
+
+        void clear() { count = 0; }
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+        [[nodiscard]] bool empty() const { return count == 0; }
+
+        Move &operator[](std::size_t idx) { return moves[idx]; }
+
+        const Move &operator[](std::size_t idx) const { return moves[idx]; }
+
+        Move *begin() { return moves.data(); }
+
+        Move *end() { return moves.data() + count; }
+
+        [[nodiscard]] const Move *begin() const { return moves.data(); }
+
+        [[nodiscard]] const Move *end() const { return moves.data() + count; }
+    };
+}
@@ -0,0 +1,56 @@
+#include "Perft.hpp"
+
+#include <chrono>
+
+namespace chess {
+    namespace {
+        uint64_t countInPlace(Bitboard &board, unsigned depth) {
+            // bulk counting from the target masks
+            if (depth == 1) return board.countLegalMoves();
+            auto moves = board.legalMoves();
+
+            uint64_t nodes = 0;
+            for (const auto &move : moves) {
+                auto undo = board.applyMoveSelf(move);
+                nodes += countInPlace(board, depth - 1);
+                board.unmakeMove(undo);
+            }
+            return nodes;
+        }
+    }
+
+    uint64_t Perft::count(const Bitboard &board, unsigned depth) {
+        if (depth == 0) return 1;
+        Bitboard workingBoard = board;
+        return countInPlace(workingBoard, depth);
+    }
+
+    std::vector<std::pair<Move, uint64_t>> Perft::divide(const Bitboard &board, unsigned depth) {
+        std::vector<std::pair<Move, uint64_t>> result;
+        if (depth == 0) return result;
+        for (const auto &move : board.legalMoves()) {
+            result.emplace_back(move, count(board.applyMoveCopy(move), depth - 1));
+        }
+        return result;
+    }
+
+    uint64_t Perft::run(std::ostream &out, const Bitboard &board, unsigned depth) {
+        auto startTime = std::chrono::steady_clock::now();
+        auto divided = divide(board, depth);
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+
+        uint64_t nodes = 0;
+        for (const auto &[move, moveNodes] : divided) {
+            out << move.toUCI() << ": " << moveNodes << std::endl;
+            nodes += moveNodes;
+        }
+        auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        uint64_t nps = elapsedUs > 0 ? nodes * 1000000 / elapsedUs : 0;
+
+        out << std::endl;
+        out << "Nodes searched: " << nodes << std::endl;
+        out << "Time (ms): " << elapsedUs / 1000 << std::endl;
+        out << "Nodes/second: " << nps << std::endl;
+        return nodes;
+    }
+}
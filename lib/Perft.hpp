@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "Bitboard.hpp"
+#include "Move.hpp"
+
+namespace chess {
+    class Perft {
+    public:
+        /**
+         * Counts all leaf nodes of the legal move tree with the given depth.
+         * Leaves are bulk counted, i.e. the last ply is not played out.
+         */
+        static uint64_t count(const Bitboard &board, unsigned depth);
+
+        /**
+         * Counts the leaf nodes below every legal root move
+         * @return pairs of root move and number of leaf nodes below that move
+         */
+        static std::vector<std::pair<Move, uint64_t>> divide(const Bitboard &board, unsigned depth);
+
+        /**
+         * Runs a divided perft and reports every root move, the total node count, time and nodes per second
+         * @param out stream to which the report is written
+         */
+        static uint64_t run(std::ostream &out, const Bitboard &board, unsigned depth);
+    };
+}
@@ -1,52 +1,127 @@
 #include "State.hpp"
 
+#include <algorithm>
 #include <cassert>
 
+#include "Attacks.hpp"
+#include "Cuckoo.hpp"
+#include "Zobrist.hpp"
+
 namespace chess {
     void State::reset() {
         stack.clear();
-        startingPosition.startpos();
+        keys.clear();
+        board.startpos();
     }
 
     void State::parseFen(std::string_view fen) {
         stack.clear();
-        startingPosition.parseFEN(fen);
+        keys.clear();
+        board.parseFEN(fen);
     }
 
     const Bitboard &State::getCurrentBitboard() const {
-        return stack.empty() ? startingPosition : stack.back();
+        return board;
     }
 
     void State::pushMove(Move move) {
-        stack.push_back(getCurrentBitboard().applyMoveCopy(move));
+        keys.push_back(board.getHash());
+        stack.push_back(board.applyMoveSelf(move));
     }
 
-    void State::pushBoard(Bitboard&& board) {
-        stack.push_back(board);
+    void State::reserve(std::size_t plies) {
+        stack.reserve(stack.size() + plies);
+        keys.reserve(keys.size() + plies);
     }
 
-    void State::popBoard() {
+    void State::popMove() {
         assert(!stack.empty());
+        if (stack.back().move == Move()) {
+            board.unmakeNullMove(stack.back());
+        } else {
+            board.unmakeMove(stack.back());
+        }
         stack.pop_back();
+        keys.pop_back();
+    }
+
+    void State::pushNullMove() {
+        keys.push_back(board.getHash());
+        stack.push_back(board.applyNullMove());
+    }
+
+    Move State::lastMove() const {
+        return stack.empty() ? Move() : stack.back().move;
     }
 
     bool State::isTreefoldRepetition() const {
-        if (stack.empty()) return false;
-        auto currentBoard = getCurrentBitboard();
-        if (currentBoard.getHalfMoveCounter() < 8) return false;
-        unsigned lastHalfMoveCount = currentBoard.getHalfMoveCounter();
-        unsigned repetitions = 1;
-        for (auto it = stack.crbegin()+1;it != stack.crend(); it++) {
-            if (lastHalfMoveCount < it->getHalfMoveCounter()) break;
-            if (*it == currentBoard) repetitions += 1;
-            if (repetitions == 3) break;
-            lastHalfMoveCount = it->getHalfMoveCounter();
+        return isRepetition(0);
+    }
+
+    bool State::isRepetition(unsigned searchPlies) const {
+        // only positions with the same side to move within the reversible moves can repeat
+        const size_t window = std::min<size_t>(keys.size(), board.getHalfMoveCounter());
+        if (window < 4) return false;
+        const uint64_t key = board.getHash();
+        unsigned earlier = 0;
+        for (size_t plies = 2; plies <= window; plies += 2) {
+            // passing the turn is not a move of the game, positions before a null move do not count
+            if (stack[stack.size() - plies + 1].move == Move() || stack[stack.size() - plies].move == Move()) break;
+            if (keys[keys.size() - plies] != key) continue;
+            if (plies < searchPlies || ++earlier == 2) return true;
         }
-        if (currentBoard == startingPosition) repetitions+=1;
-        return (repetitions >= 3);
+        return false;
+    }
+
+    bool State::hasUpcomingRepetition(unsigned searchPlies) const {
+        const size_t window = std::min<size_t>(keys.size(), board.getHalfMoveCounter());
+        if (window < 3 || stack.back().move == Move()) return false;
+        const uint64_t key = board.getHash();
+        const size_t n = keys.size();
+        // key changes of the opponent's moves, zero once they cancel out
+        uint64_t opponentMoves = key ^ keys[n - 1] ^ Zobrist::side();
+        for (size_t plies = 3; plies <= window; plies += 2) {
+            if (stack[n - plies + 1].move == Move() || stack[n - plies].move == Move()) break;
+            opponentMoves ^= keys[n - plies + 1] ^ keys[n - plies] ^ Zobrist::side();
+            if (opponentMoves != 0) continue;
+            // the own moves in between add up to a single move back to the earlier position
+            Move move = Cuckoo::find(key ^ keys[n - plies]);
+            if (move == Move() || (Attacks::between(move.fromSquare(), move.toSquare()) & board.occupied()) != 0) {
+                continue;
+            }
+            // repeating a position before the root is no draw yet
+            if (plies < searchPlies) return true;
+        }
+        return false;
+    }
+
+    NodeStatus State::status(unsigned searchPlies, MoveList &moves) const {
+        NodeStatus result = drawStatus(searchPlies);
+        if (result != NodeStatus::Ongoing) return result;
+        moves = board.legalMoves();
+        return moveStatus(!moves.empty());
+    }
+
+    NodeStatus State::status(unsigned searchPlies) const {
+        NodeStatus result = drawStatus(searchPlies);
+        if (result != NodeStatus::Ongoing) return result;
+        return moveStatus(board.hasLegalMove());
+    }
+
+    NodeStatus State::drawStatus(unsigned searchPlies) const {
+        if (isRepetition(searchPlies)) return NodeStatus::Repetition;
+        if (board.isDrawInsufficient()) return NodeStatus::InsufficientMaterial;
+        return NodeStatus::Ongoing;
+    }
+
+    NodeStatus State::moveStatus(bool hasLegalMove) const {
+        // a mate on the last move before the fifty move rule still counts
+        if (!hasLegalMove) return board.isCheck() ? NodeStatus::Checkmate : NodeStatus::Stalemate;
+        if (board.isDraw50()) return NodeStatus::FiftyMoves;
+        return NodeStatus::Ongoing;
     }
 
     bool State::isGameOver() const {
-        return getCurrentBitboard().isGameOver() | isTreefoldRepetition();
+        return status() != NodeStatus::Ongoing;
     }
 }
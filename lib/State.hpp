@@ -9,10 +9,25 @@
 #include <stack>
 
 namespace chess {
+/**
+ * Whether and why the game is over in a position
+ */
+enum class NodeStatus : uint8_t {
+    Ongoing,
+    Checkmate,
+    Stalemate,
+    FiftyMoves,
+    InsufficientMaterial,
+    Repetition
+};
+
 class State {
 private:
-    Bitboard startingPosition;
-    std::vector<Bitboard> stack;
+    Bitboard board;
+    // undo records of all played moves, the last entry belongs to the current position
+    std::vector<Bitboard::Undo> stack;
+    // Zobrist keys of the positions before each played move, used for repetition detection
+    std::vector<uint64_t> keys;
 
 
 public:
@@ -20,10 +35,53 @@ public:
   void parseFen(std::string_view);
   [[nodiscard]] const Bitboard& getCurrentBitboard() const;
   void pushMove(Move);
-  void pushBoard(Bitboard&&);
-  void popBoard();
+  /**
+   * Reserves room for the given number of further moves, so pushing them does not allocate
+   */
+  void reserve(std::size_t plies);
+  void popMove();
+  /**
+   * Passes the turn, popMove takes the null move back
+   */
+  void pushNullMove();
+  /**
+   * @return the move leading to the current position or Move() if no move was played since the last reset
+   * or the last move was a null move
+   */
+  [[nodiscard]] Move lastMove() const;
 
   bool isTreefoldRepetition() const;
+  /**
+   * Classifies the position once, cheap draw rules first. The legal moves are generated into moves,
+   * so a node that is not over can be expanded without generating them again.
+   * @param searchPlies distance to the search root for the repetition rule, see isRepetition
+   * @param moves filled with the legal moves if the position is Ongoing
+   */
+  NodeStatus status(unsigned searchPlies, MoveList& moves) const;
+  /**
+   * Classifies the position without building the move list, for leaves that are not expanded
+   */
+  [[nodiscard]] NodeStatus status(unsigned searchPlies = 0) const;
+  /**
+   * The draw rules of status that need no legal moves: repetition and insufficient material
+   */
+  [[nodiscard]] NodeStatus drawStatus(unsigned searchPlies) const;
+  /**
+   * The rules of status that depend on the legal moves: mate, stalemate and the fifty move rule,
+   * to be checked after drawStatus
+   */
+  [[nodiscard]] NodeStatus moveStatus(bool hasLegalMove) const;
+  /**
+   * Repetition rule of the search: a position repeating one that occurred after the search root is already a draw,
+   * positions from before the root have to occur three times.
+   * @param searchPlies distance of the current position to the search root, 0 outside of a search
+   */
+  [[nodiscard]] bool isRepetition(unsigned searchPlies) const;
+  /**
+   * @param searchPlies distance of the current position to the search root
+   * @return true if the side to move can repeat a position of the search tree with a single reversible move
+   */
+  [[nodiscard]] bool hasUpcomingRepetition(unsigned searchPlies) const;
   bool isGameOver() const;
 };
 }
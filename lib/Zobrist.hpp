@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace chess {
+    namespace internal {
+        // 2 colors * 6 pieces * 64 squares, 16 castling right combinations, 8 en passant files, side to move
+        constexpr std::size_t zobristCastlingOffset = 2 * 6 * 64;
+        constexpr std::size_t zobristEnPassantOffset = zobristCastlingOffset + 16;
+        constexpr std::size_t zobristSideOffset = zobristEnPassantOffset + 8;
+
+        constexpr uint64_t splitmix(uint64_t &state) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31u);
+        }
+
+        constexpr std::array<uint64_t, zobristSideOffset + 1> generateZobristKeys() {
+            std::array<uint64_t, zobristSideOffset + 1> keys{};
+            uint64_t state = 0x4d43686573735453ull;
+            for (auto &key : keys) key = splitmix(state);
+            // no castling rights do not change the key
+            keys[zobristCastlingOffset] = 0;
+            return keys;
+        }
+
+        inline constexpr auto zobristKeys = generateZobristKeys();
+    }
+
+    /**
+     * Random keys for Zobrist hashing. The tables are generated at compile time with splitmix64.
+     */
+    class Zobrist {
+    private:
+        static constexpr unsigned pieceIndex(char piece) {
+            switch (piece) {
+                case 'p':
+                    return 0;
+                case 'n':
+                    return 1;
+                case 'b':
+                    return 2;
+                case 'r':
+                    return 3;
+                case 'q':
+                    return 4;
+                default:
+                    return 5;
+            }
+        }
+
+    public:
+        /**
+         * @param color true for white
+         * @param piece lower case piece character
+         */
+        static constexpr uint64_t piece(bool color, char piece, unsigned square) {
+            return internal::zobristKeys[(color * 6 + pieceIndex(piece)) * 64 + square];
+        }
+
+        static uint64_t castling(const std::bitset<4> &castlingRights) {
+            return internal::zobristKeys[internal::zobristCastlingOffset + castlingRights.to_ulong()];
+        }
+
+        static constexpr uint64_t enPassant(unsigned file) { return internal::zobristKeys[internal::zobristEnPassantOffset + file]; }
+
+        /**
+         * Key toggled when black is to move
+         */
+        static constexpr uint64_t side() { return internal::zobristKeys[internal::zobristSideOffset]; }
+    };
+}
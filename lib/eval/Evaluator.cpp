@@ -3,13 +3,17 @@
 #include <bit>
 namespace chess {
     Score Evaluator::operator()(const State &state) const {
-        if (state.isGameOver()) {
-            if (state.getCurrentBitboard().isCheck()) {
+        return (*this)(state, state.status());
+    }
+
+    Score Evaluator::operator()(const State &state, NodeStatus status) const {
+        switch (status) {
+            case NodeStatus::Ongoing:
+                return this->evalNotGameOver(state);
+            case NodeStatus::Checkmate:
                 return Score(true, state.getCurrentBitboard().getPov() ? -1 : 1);
-            } else {
+            default:
                 return Score(0);
-            }
         }
-        return this->evalNotGameOver(state);
     }
 }
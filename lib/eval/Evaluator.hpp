@@ -10,6 +10,10 @@ private:
     [[nodiscard]] virtual Score evalNotGameOver(const State&) const = 0;
 public:
     Score operator()(const State&) const;
+    /**
+     * Evaluates a position whose status is already known, so the game over checks are not repeated
+     */
+    Score operator()(const State&, NodeStatus status) const;
 };
 
 } // namespace chess
@@ -1,109 +1,503 @@
 
 #include "AlphaBetaSearch.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <vector>
-#include <chrono>
 #include <thread>
-#include <iostream>
 
 namespace chess {
-    Move AlphaBetaSearch::findNextMove(State &state, const Clock &clock) {
+    Move AlphaBetaSearch::findNextMove(State &state, const Clock &clock, std::stop_token stopToken) {
         Move bestMove{0,0};
-        auto worker = std::thread(iterativeDeepeningSearch,std::ref(state),std::ref(evaluator), std::ref(bestMove),std::ref(clock));
+        std::vector<Move> pv;
+        transpositionTable.newSearch();
+        limits = computeLimits(clock, state.getCurrentBitboard().getPov());
+        {
+            std::lock_guard lock(stopMutex);
+            // a ponderhit received since prepare has already ended pondering and must not be undone
+            if (!prepared) startClock(clock);
+            prepared = false;
+        }
+        stopped = false;
+        // runs right away if the stop was requested before the search started
+        std::stop_callback onStop(stopToken, [this] {
+            {
+                std::lock_guard lock(stopMutex);
+                stopped = true;
+            }
+            stopCondition.notify_all();
+        });
+        // the undo records of the whole search line fit without reallocating
+        state.reserve(maxPly);
+        for (unsigned i = 0; i < threadCount; i++) {
+            threads[i].nodes.nodes = 0;
+            threads[i].selectiveDepth = 0;
+            threads[i].history.age();
+        }
+        std::vector<std::thread> helpers;
+        for (unsigned i = 1; i < threadCount; i++) {
+            helpers.emplace_back(&AlphaBetaSearch::helperSearch, this, state, i);
+        }
+        auto worker = std::thread(&AlphaBetaSearch::iterativeDeepeningSearch, this, std::ref(state), std::ref(bestMove), std::ref(pv));
         worker.join();
+        // infinite and ponder searches must not return before stop (or ponderhit),
+        // even if the main thread already reached the maximum depth
+        {
+            std::unique_lock lock(stopMutex);
+            stopCondition.wait(lock, [this] { return stopped || (!limits.infinite && !pondering); });
+            stopped = true;
+        }
+        for (auto &helper : helpers) {
+            helper.join();
+        }
+        expectedReply = findExpectedReply(state, bestMove, pv);
         return bestMove;
     }
 
-    void AlphaBetaSearch::iterativeDeepeningSearch(State& state, const Evaluator& evaluator, Move& bestMove, const Clock& clock) {
-        std::vector<Move> pv;
-        unsigned depth;
-        uint64_t nodes = 0;
-        auto startTime = std::chrono::high_resolution_clock::now();
-        auto increment = std::chrono::milliseconds(state.getCurrentBitboard().getPov() ? clock.white_increment_ms : clock.black_increment_ms);
-        for (depth = 1; depth < 6 && (std::chrono::high_resolution_clock::now() < (startTime+increment)) ; depth++) {
-            std::vector<Move> line;
-            auto score = search(state, depth, state.getCurrentBitboard().getPov(), std::nullopt, std::nullopt, line, pv.cbegin(), pv.cend(), evaluator, nodes);
-            pv = std::move(line);
-            bestMove = pv.front();
-            if (score.isMate) {
-                break;
+    void AlphaBetaSearch::prepare(const Clock &clock) {
+        std::lock_guard lock(stopMutex);
+        startClock(clock);
+        prepared = true;
+    }
+
+    void AlphaBetaSearch::startClock(const Clock &clock) {
+        searchStart = std::chrono::steady_clock::now();
+        goTime = searchStart;
+        lastReport = goTime;
+        pondering = clock.ponder;
+    }
+
+    void AlphaBetaSearch::ponderhit() {
+        {
+            std::lock_guard lock(stopMutex);
+            searchStart = std::chrono::steady_clock::now();
+            pondering = false;
+        }
+        stopCondition.notify_all();
+    }
+
+    Move AlphaBetaSearch::findExpectedReply(State &state, Move bestMove, const std::vector<Move> &pv) const {
+        if (bestMove == Move()) return Move();
+        state.pushMove(bestMove);
+        // the line may end in an unchecked transposition table move or be cut short by a table hit
+        Move reply = Move();
+        if (pv.size() >= 2 && pv.front() == bestMove) {
+            reply = pv[1];
+        } else {
+            TranspositionTable::Entry entry{};
+            if (transpositionTable.probe(state.getCurrentBitboard().getHash(), entry)) reply = entry.move;
+        }
+        auto moves = state.getCurrentBitboard().legalMoves();
+        if (std::find(moves.begin(), moves.end(), reply) == moves.end()) reply = Move();
+        state.popMove();
+        return reply;
+    }
+
+    std::vector<SearchOption> AlphaBetaSearch::options() const {
+        PruningParameters defaults;
+        return {{"Hash", TranspositionTable::defaultSizeMb, 1, 65536},
+                {"Threads", 1, 1, maxThreads},
+                {"FutilityMargin", defaults.futilityMargin, 0, 1000},
+                {"ReverseFutilityMargin", defaults.reverseFutilityMargin, 0, 1000},
+                {"LMRBase", defaults.lmrBase, 0, 500},
+                {"LMRDivisor", defaults.lmrDivisor, 50, 1000}};
+    }
+
+    bool AlphaBetaSearch::setOption(const std::string &name, int value) {
+        if (name == "Hash") {
+            transpositionTable.resize(std::clamp(value, 1, 65536));
+            return true;
+        }
+        if (name == "Threads") {
+            threadCount = std::clamp(value, 1, static_cast<int>(maxThreads));
+            threads = std::make_unique<ThreadData[]>(threadCount);
+            return true;
+        }
+        if (name == "FutilityMargin") {
+            pruning.futilityMargin = std::clamp(value, 0, 1000);
+            return true;
+        }
+        if (name == "ReverseFutilityMargin") {
+            pruning.reverseFutilityMargin = std::clamp(value, 0, 1000);
+            return true;
+        }
+        if (name == "LMRBase") {
+            pruning.lmrBase = std::clamp(value, 0, 500);
+            initLateMoveReductions();
+            return true;
+        }
+        if (name == "LMRDivisor") {
+            pruning.lmrDivisor = std::clamp(value, 50, 1000);
+            initLateMoveReductions();
+            return true;
+        }
+        return false;
+    }
+
+    void AlphaBetaSearch::initLateMoveReductions() {
+        for (unsigned depth = 1; depth < lmrTableSize; depth++) {
+            for (unsigned moveCount = 1; moveCount < lmrTableSize; moveCount++) {
+                double reduction = pruning.lmrBase
+                                   + std::log(depth) * std::log(moveCount) * 10000.0 / pruning.lmrDivisor;
+                lateMoveReductions[depth][moveCount] = static_cast<uint8_t>(std::min(reduction / 100.0, 32.0));
             }
-            std::cerr << "info nodes " << nodes << std::endl;
-            std::cerr << "info depth " << depth << std::endl;
         }
     }
 
-    Score AlphaBetaSearch::search(State &state, unsigned maxDepth, bool max, std::optional<Score> alpha,
-                                  std::optional<Score> beta, std::vector<Move> &line, std::vector<Move>::const_iterator pvBegin, std::vector<Move>::const_iterator pvEnd,const Evaluator& evaluator, uint64_t& nodes) {
-        if (maxDepth == 0 || state.isGameOver()) {
-            nodes++;
-            return evaluator(state);
+    unsigned AlphaBetaSearch::lateMoveReduction(unsigned depth, unsigned moveCount) const {
+        return lateMoveReductions[std::min(depth, lmrTableSize - 1)][std::min(moveCount, lmrTableSize - 1)];
+    }
+
+    void AlphaBetaSearch::newGame() {
+        transpositionTable.clear();
+        for (unsigned i = 0; i < threadCount; i++) {
+            threads[i].history.clear();
+        }
+    }
+
+    AlphaBetaSearch::SearchLimits AlphaBetaSearch::computeLimits(const Clock &clock, bool pov) {
+        SearchLimits result;
+        result.depth = clock.depth > 0 ? std::min(clock.depth, maxSearchDepth) : maxSearchDepth;
+        result.nodes = clock.nodes;
+        if (clock.infinite) {
+            result.infinite = true;
+            result.depth = maxSearchDepth;
+            result.nodes = 0;
+            return result;
         }
-        std::optional<Score> bestScore;
-        std::vector<Bitboard> nextBoards;
-        std::vector<Move> moves = state.getCurrentBitboard().legalMoves();
-        nextBoards.reserve(moves.size());
-        for (auto move : moves) {
-            nextBoards.push_back(state.getCurrentBitboard().applyMoveCopy(move));
+        int time = pov ? clock.white_time_ms : clock.black_time_ms;
+        int increment = pov ? clock.white_increment_ms : clock.black_increment_ms;
+        int soft = 0;
+        int hard = 0;
+        if (clock.move_time_ms > 0) {
+            soft = hard = std::max(1, clock.move_time_ms - moveOverheadMs);
+        } else if (time > 0) {
+            int available = std::max(1, time - moveOverheadMs);
+            int movesToGo = clock.moves_to_go > 0 ? clock.moves_to_go : defaultMovesToGo;
+            // never plan to use more than three quarters of the remaining time on a single move
+            hard = std::max(1, available * 3 / 4);
+            // at least a millisecond each, a low clock must still bound the search
+            soft = std::max(1, std::min(available / movesToGo + increment * 3 / 4, hard));
+            hard = std::max(soft, std::min(hard, 4 * soft));
+        } else if (increment > 0) {
+            // without a main time only the increment can be spent
+            soft = increment / 2;
+            hard = increment;
+        } else if (clock.depth == 0 && clock.nodes == 0) {
+            result.depth = defaultDepth;
         }
-        auto sortFunction = presortingLessThen(state.getCurrentBitboard().getPov());
-        for (auto it = nextBoards.begin(); it != nextBoards.end(); it++) {
-            auto minIt = std::min_element(it, nextBoards.end(), sortFunction);
-            auto idx = it - nextBoards.begin();
-            auto minIdx = minIt - nextBoards.begin();
-            std::iter_swap(it, minIt);
-            std::iter_swap(moves.begin()+idx, moves.begin()+minIdx);
-            Bitboard board = std::move(*it);
-            Move move = *(moves.begin()+idx);
+        if (hard > 0) {
+            result.timed = true;
+            result.softTime = std::chrono::milliseconds(soft);
+            result.hardTime = std::chrono::milliseconds(hard);
+        }
+        return result;
+    }
 
+    bool AlphaBetaSearch::timeLimitReached(std::chrono::milliseconds limit) const {
+        if (!limits.timed || pondering.load()) return false;
+        return std::chrono::steady_clock::now() - searchStart.load() >= limit;
+    }
 
+    uint64_t AlphaBetaSearch::totalNodes() const {
+        uint64_t result = 0;
+        for (unsigned i = 0; i < threadCount; i++) {
+            result += threads[i].nodes.nodes.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
 
-            state.pushBoard(std::move(board));
-            std::vector<Move> nextLine;
-            auto nextScore = search(state, maxDepth - 1, !max, alpha, beta, nextLine, pvBegin, pvEnd,evaluator,nodes);
-            state.popBoard();
-            // update new optimum
-            if (!bestScore || (max ? nextScore > bestScore.value() : nextScore < bestScore.value())) {
-                bestScore = nextScore;
-                line = std::move(nextLine);
-                line.insert(line.begin(), move);
-            }
-            // alpha pruning
-            if (!max && alpha.has_value() && bestScore.value() < alpha.value()) {
+    void AlphaBetaSearch::countNode(ThreadData &thread) {
+        thread.nodes.increment();
+        if (&thread != &threads[0] || thread.nodes.nodes.load(std::memory_order_relaxed) % limitCheckInterval != 0) {
+            return;
+        }
+        if (timeLimitReached(limits.hardTime) || (limits.nodes > 0 && totalNodes() >= limits.nodes)) {
+            stopped = true;
+        }
+        if (std::chrono::steady_clock::now() - lastReport >= infoInterval) {
+            reportProgress();
+        }
+    }
+
+    void AlphaBetaSearch::reportProgress(unsigned depth, std::optional<int> value, const std::vector<Move> &pv) {
+        lastReport = std::chrono::steady_clock::now();
+        if (!infoCallback) return;
+        SearchInfo info;
+        info.depth = depth;
+        info.selectiveDepth = depth > 0 ? threads[0].selectiveDepth : 0;
+        // the value is relative to the side to move, which is what UCI expects
+        if (value) info.score = SearchValue::toScore(*value, true);
+        info.nodes = totalNodes();
+        info.time = std::chrono::duration_cast<std::chrono::milliseconds>(lastReport - goTime);
+        info.hashfull = transpositionTable.hashfull();
+        info.pv = pv;
+        report(info);
+    }
+
+    void AlphaBetaSearch::iterativeDeepeningSearch(State& state, Move& bestMove, std::vector<Move>& pv) {
+        int value = 0;
+        // a move is returned even if not even the first iteration finishes in time
+        auto rootMoves = state.getCurrentBitboard().legalMoves();
+        if (!rootMoves.empty()) bestMove = rootMoves[0];
+        std::vector<Move> line;
+        int completedValue = 0;
+        for (unsigned depth = 1; depth <= limits.depth; depth++) {
+            value = aspirationSearch(state, depth, value, line, pv, threads[0]);
+            // the aborted iteration is incomplete, the previous one is kept and reported with the final node count
+            if (stopped.load(std::memory_order_relaxed)) {
+                if (depth > 1) reportProgress(depth - 1, completedValue, pv);
                 break;
             }
-            // beta pruning
-            if (max && beta.has_value() && bestScore.value() > beta.value()) {
+            completedValue = value;
+            pv.swap(line);
+            // a root position that is already over has no line
+            if (!pv.empty()) bestMove = pv.front();
+            reportProgress(depth, value, pv);
+            if (SearchValue::isMate(value)) {
                 break;
             }
-            // mate pruning
-            if (max && bestScore.value().isMate && bestScore.value().value > 0) {
+            if (timeLimitReached(limits.softTime)) {
                 break;
             }
-            if (!max && bestScore.value().isMate && bestScore.value().value < 0) {
+        }
+    }
+
+    void AlphaBetaSearch::helperSearch(State state, unsigned threadIndex) {
+        std::vector<Move> pv, line;
+        int value = 0;
+        state.reserve(maxPly);
+        for (unsigned depth = 1 + threadIndex % 2; depth <= maxSearchDepth && !stopped.load(std::memory_order_relaxed); depth++) {
+            value = aspirationSearch(state, depth, value, line, pv, threads[threadIndex]);
+            if (stopped.load(std::memory_order_relaxed) || SearchValue::isMate(value)) {
                 break;
             }
-            // update alpha and beta
-            if (max && (!alpha.has_value() || bestScore.value() > alpha.value())) {
-                alpha = bestScore;
+            pv.swap(line);
+        }
+    }
+
+    int AlphaBetaSearch::aspirationSearch(State &state, unsigned depth, int previousValue, std::vector<Move> &line,
+                                          const std::vector<Move> &pv, ThreadData &thread) {
+        int delta = aspirationWindow;
+        int alpha = -SearchValue::infinity;
+        int beta = SearchValue::infinity;
+        if (depth >= aspirationMinDepth && !SearchValue::isMate(previousValue)) {
+            alpha = std::max(previousValue - delta, -SearchValue::infinity);
+            beta = std::min(previousValue + delta, SearchValue::infinity);
+        }
+        while (true) {
+            int value = search(state, depth, 0, alpha, beta, pv.cbegin(), pv.cend(), thread);
+            if (stopped.load(std::memory_order_relaxed)) {
+                return value;
             }
-            if (!max && (!beta.has_value() || bestScore.value() < beta.value())) {
-                beta = bestScore;
+            auto rootLine = thread.pvTable.line(0);
+            line.assign(rootLine.begin(), rootLine.end());
+            // widen the failing side of the window until the value lies inside
+            delta *= 2;
+            if (value <= alpha && alpha > -SearchValue::infinity) {
+                alpha = std::max(value - delta, -SearchValue::infinity);
+            } else if (value >= beta && beta < SearchValue::infinity) {
+                beta = std::min(value + delta, SearchValue::infinity);
+            } else {
+                return value;
             }
         }
-        assert(bestScore);
-        return bestScore.value();
     }
 
+    int AlphaBetaSearch::evaluate(const State &state, unsigned ply, NodeStatus status) const {
+        return SearchValue::fromScore(evaluator(state, status), state.getCurrentBitboard().getPov(), ply);
+    }
 
-    bool presortingLessThen::operator()(const Bitboard &lhs, const Bitboard &rhs) {
-        bool leftCheck = lhs.isCheck();
-        bool rightCheck = rhs.isCheck();
+    int AlphaBetaSearch::search(State &state, unsigned depth, unsigned ply, int alpha, int beta,
+                                std::vector<Move>::const_iterator pvBegin, std::vector<Move>::const_iterator pvEnd,
+                                ThreadData &thread) {
+        // horizon nodes are counted once by quiescence
+        if (depth > 0) countNode(thread);
+        thread.pvTable.clear(ply);
+        thread.selectiveDepth = std::max(thread.selectiveDepth, ply);
+        // if the side to move can repeat a position of the search tree it scores at least a draw
+        if (ply > 0 && alpha < SearchValue::draw && state.hasUpcomingRepetition(ply)) {
+            alpha = SearchValue::draw;
+            if (alpha >= beta) {
+                // cut before quiescence could count it
+                if (depth == 0) countNode(thread);
+                return alpha;
+            }
+        }
+        if (depth == 0) {
+            return quiescence(state, ply, alpha, beta, thread);
+        }
+        // Repeating a position of the search tree is already a draw, whoever could avoid it did not.
+        NodeStatus status = state.drawStatus(ply);
+        if (status != NodeStatus::Ongoing) {
+            return evaluate(state, ply, status);
+        }
+        const auto &board = state.getCurrentBitboard();
+        // a window wider than null can still change the principal variation
+        const bool pvNode = beta - alpha > 1;
+        const uint64_t hash = board.getHash();
+        TranspositionTable::Entry entry{};
+        bool hashHit = transpositionTable.probe(hash, entry);
+        // cut only in zero window nodes, principal variation nodes need a full line.
+        // The key does not include the half move clock, so no cut once the fifty move rule may apply.
+        if (hashHit && !pvNode && ply > 0 && entry.depth >= depth && !board.isDraw50()) {
+            int hashValue = SearchValue::fromTranspositionTable(entry.value, ply);
+            if (entry.bound == TranspositionTable::Bound::Exact
+                || (entry.bound == TranspositionTable::Bound::Lower && hashValue >= beta)
+                || (entry.bound == TranspositionTable::Bound::Upper && hashValue <= alpha)) {
+                if (entry.move != Move()) thread.pvTable.set(ply, entry.move);
+                return hashValue;
+            }
+        }
+        // the legal moves generated to tell whether the game is over are the ones searched below
+        SearchFrame &frame = thread.stack[ply];
+        frame.moves = board.legalMoves();
+        status = state.moveStatus(!frame.moves.empty());
+        if (status != NodeStatus::Ongoing) {
+            return evaluate(state, ply, status);
+        }
+        const Move previousMove = state.lastMove();
+        const bool inCheck = board.isCheck();
+        frame.staticValue = inCheck ? -SearchValue::infinity : evaluate(state, ply, status);
+        // reverse futility pruning: close to the leaves a large enough margin above beta will hardly be lost
+        if (!pvNode && !inCheck && ply > 0 && depth <= futilityMaxDepth && pruning.reverseFutilityMargin > 0
+            && !SearchValue::isMate(beta)
+            && frame.staticValue - pruning.reverseFutilityMargin * static_cast<int>(depth) >= beta) {
+            return frame.staticValue;
+        }
+        // null move pruning: if passing still fails high the position is good enough to cut.
+        // Not in check (passing would be illegal), not twice in a row (previousMove is Move() after a null move)
+        // and not with pawns only, where zugzwang makes passing an advantage.
+        uint64_t nonPawnMaterial = (board.getKnights() | board.getBishops() | board.getRooks() | board.getQueens())
+                                   & board.getOccupied(board.getPov());
+        if (!pvNode && !inCheck && ply > 0 && depth >= nullMoveMinDepth && previousMove != Move()
+            && nonPawnMaterial != 0 && frame.staticValue >= beta) {
+            unsigned reduction = std::min(depth, nullMoveReduction + depth / 4);
+            state.pushNullMove();
+            int value = -search(state, depth - reduction, ply + 1, -beta, -beta + 1, pvEnd, pvEnd, thread);
+            state.popMove();
+            if (stopped.load(std::memory_order_relaxed)) {
+                return value;
+            }
+            if (value >= beta) {
+                // mates found after passing are not proven
+                return SearchValue::isMate(value) ? beta : value;
+            }
+        }
+        // futility pruning: quiet moves cannot raise a static evaluation far below alpha
+        const bool futile = !pvNode && !inCheck && depth <= futilityMaxDepth && pruning.futilityMargin > 0
+                            && !SearchValue::isMate(alpha)
+                            && frame.staticValue + pruning.futilityMargin * static_cast<int>(depth) <= alpha;
+        const int originalAlpha = alpha;
+        int bestValue = -SearchValue::infinity;
+        // along the principal variation of the previous iteration its move is tried first,
+        // everywhere else the best move of an earlier search of this position
+        Move firstMove = hashHit ? entry.move : Move();
+        if (pvBegin != pvEnd) firstMove = *pvBegin;
+        MovePicker &picker = frame.picker.emplace(board, frame.moves, firstMove, &thread.history, ply, previousMove);
+        MoveList &triedQuiets = frame.triedQuiets;
+        triedQuiets.clear();
+        unsigned moveCount = 0;
+        Move move;
+        while (picker.next(move)) {
+            const bool quiet = MovePicker::isQuiet(board, move);
+            // the children of the principal variation move continue along the variation
+            bool followsPv = pvBegin != pvEnd && move == *pvBegin;
+            auto childPvBegin = followsPv ? pvBegin + 1 : pvEnd;
+            // at least one move is searched so the node has a best move
+            if (futile && quiet && moveCount > 0) {
+                continue;
+            }
+            moveCount++;
+            state.pushMove(move);
+            int value;
+            if (moveCount == 1) {
+                value = -search(state, depth - 1, ply + 1, -beta, -alpha, childPvBegin, pvEnd, thread);
+            } else {
+                // late quiet moves are searched with reduced depth, unless they escape or give check
+                unsigned reduction = 0;
+                if (quiet && !inCheck && depth >= lmrMinDepth && moveCount >= lmrMinMoveCount
+                    && !state.getCurrentBitboard().isCheck()) {
+                    reduction = lateMoveReduction(depth, moveCount);
+                    if (pvNode && reduction > 0) reduction--;
+                    reduction = std::min(reduction, depth - 2);
+                }
+                // later moves only have to prove they are worse than the best one so far
+                value = -search(state, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha, childPvBegin, pvEnd, thread);
+                if (value > alpha && reduction > 0) {
+                    value = -search(state, depth - 1, ply + 1, -alpha - 1, -alpha, childPvBegin, pvEnd, thread);
+                }
+                if (value > alpha && value < beta) {
+                    value = -search(state, depth - 1, ply + 1, -beta, -alpha, childPvBegin, pvEnd, thread);
+                }
+            }
+            state.popMove();
+            // results of an aborted helper are incomplete, neither use nor store them
+            if (stopped.load(std::memory_order_relaxed)) {
+                return value;
+            }
+            if (value > bestValue) {
+                bestValue = value;
+                thread.pvTable.update(ply, move);
+            }
+            if (value > alpha) {
+                alpha = value;
+            }
+            // beta cutoff, quiet moves causing it are remembered for move ordering
+            if (alpha >= beta) {
+                if (quiet) {
+                    thread.history.onCutoff(board.getPov(), ply, depth, move, previousMove,
+                                            triedQuiets.begin(), triedQuiets.end());
+                }
+                break;
+            }
+            if (quiet) triedQuiets.push_back(move);
+        }
+        assert(moveCount > 0);
+        auto bound = TranspositionTable::Bound::Exact;
+        if (bestValue >= beta) {
+            bound = TranspositionTable::Bound::Lower;
+        } else if (bestValue <= originalAlpha) {
+            bound = TranspositionTable::Bound::Upper;
+        }
+        transpositionTable.store(hash, thread.pvTable.bestMove(ply), SearchValue::toTranspositionTable(bestValue, ply), depth, bound);
+        return bestValue;
+    }
 
-        if (leftCheck ^ rightCheck) return leftCheck;
-        auto leftEval = evaluator.evalNotGameOver(lhs);
-        auto rightEval = evaluator.evalNotGameOver(rhs);
-        return maximize ? leftEval > rightEval : leftEval < rightEval;
+    int AlphaBetaSearch::quiescence(State &state, unsigned ply, int alpha, int beta, ThreadData &thread) {
+        countNode(thread);
+        thread.selectiveDepth = std::max(thread.selectiveDepth, ply);
+        const auto &board = state.getCurrentBitboard();
+        if (ply >= maxPly) {
+            return evaluate(state, ply, state.status(ply));
+        }
+        const bool inCheck = board.isCheck();
+        // in check all evasions are searched, so their list doubles as the game over test
+        SearchFrame &frame = thread.stack[ply];
+        const NodeStatus status = inCheck ? state.status(ply, frame.moves) : state.status(ply);
+        if (status != NodeStatus::Ongoing) {
+            return evaluate(state, ply, status);
+        }
+        int bestValue = -SearchValue::infinity;
+        if (!inCheck) {
+            bestValue = evaluate(state, ply, status);
+            if (bestValue >= beta) return bestValue;
+            alpha = std::max(alpha, bestValue);
+        }
+        MovePicker &picker = frame.picker.emplace(board, inCheck ? frame.moves : board.captureMoves());
+        Move move;
+        while (picker.next(move)) {
+            state.pushMove(move);
+            int value = -quiescence(state, ply + 1, -beta, -alpha, thread);
+            state.popMove();
+            if (stopped.load(std::memory_order_relaxed)) {
+                return value;
+            }
+            bestValue = std::max(bestValue, value);
+            alpha = std::max(alpha, value);
+            if (alpha >= beta) break;
+        }
+        return bestValue;
     }
-}
\ No newline at end of file
+}
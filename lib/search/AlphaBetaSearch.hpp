@@ -3,23 +3,179 @@
 #include <vector>
 #include "Search.hpp"
 #include "Move.hpp"
+#include "MoveHistory.hpp"
+#include "MovePicker.hpp"
+#include "PrincipalVariationTable.hpp"
+#include "SearchStack.hpp"
+#include "SearchValue.hpp"
+#include "TranspositionTable.hpp"
+#include <array>
 #include <atomic>
-#include <eval/PiecePositionEvaluator.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 namespace chess {
 class AlphaBetaSearch : public Search {
 public:
-    Move findNextMove(State &state, const Clock &clock) override;
-    AlphaBetaSearch(Evaluator& evaluator) : Search(evaluator) {};
+    using Search::findNextMove;
+    Move findNextMove(State &state, const Clock &clock, std::stop_token stopToken) override;
+    void prepare(const Clock &clock) override;
+    [[nodiscard]] std::vector<SearchOption> options() const override;
+    bool setOption(const std::string& name, int value) override;
+    void newGame() override;
+    void ponderhit() override;
+    [[nodiscard]] Move ponderMove() const override { return expectedReply; }
+    AlphaBetaSearch(Evaluator& evaluator) : Search(evaluator) { initLateMoveReductions(); };
 private:
-    static void iterativeDeepeningSearch(State& state,const Evaluator& evaluator, Move& bestMove, const Clock& clock);
-    static Score search(State &state, unsigned maxDepth, bool max, std::optional<Score> alpha, std::optional<Score> beta, std::vector<Move>& line, std::vector<Move>::const_iterator pvBegin, std::vector<Move>::const_iterator pvEnd, const Evaluator& evaluator, uint64_t& nodes);
-};
-struct presortingLessThen {
-public:
-    PiecePositionEvaluator evaluator;
-    bool maximize;
-    explicit presortingLessThen(bool maximize) : evaluator(), maximize(maximize) {};
-    inline bool operator() (const Bitboard&,const Bitboard&);
+    /**
+     * Node counter of one search thread, padded to a cache line so threads do not share lines while counting
+     */
+    struct alignas(64) NodeCounter {
+        std::atomic<uint64_t> nodes{0};
+        void increment() { nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    };
+
+    /**
+     * Everything owned by a single search thread, kept between searches
+     */
+    struct ThreadData {
+        NodeCounter nodes;
+        MoveHistory history;
+        PrincipalVariationTable pvTable;
+        SearchStack stack;
+        // highest ply reached in the current search, including quiescence
+        unsigned selectiveDepth = 0;
+    };
+
+    static constexpr unsigned maxThreads = 256;
+    // quiescence search falls back to the static evaluation beyond this ply
+    static constexpr unsigned maxPly = PrincipalVariationTable::maxPly;
+    static_assert(SearchStack::maxPly == maxPly);
+    // half width of the first aspiration window around the previous iteration's value
+    static constexpr int aspirationWindow = 25;
+    static constexpr unsigned aspirationMinDepth = 3;
+    static constexpr unsigned nullMoveMinDepth = 3;
+    // depth reduction of the null move search, grows by one every four plies of depth
+    static constexpr unsigned nullMoveReduction = 2;
+
+    /**
+     * Forward pruning parameters adjustable through setOption, margins of 0 disable the pruning
+     */
+    struct PruningParameters {
+        // skip quiet moves if the static evaluation plus margin * depth cannot reach alpha
+        int futilityMargin = 100;
+        // cut if the static evaluation minus margin * depth is still above beta
+        int reverseFutilityMargin = 80;
+        // late move reduction = (base + ln(depth) * ln(move number) * 10000 / divisor) / 100
+        int lmrBase = 75;
+        int lmrDivisor = 225;
+    };
+
+    // futility and reverse futility pruning only close to the leaves
+    static constexpr unsigned futilityMaxDepth = 3;
+    static constexpr unsigned lmrMinDepth = 3;
+    // the first moves are never reduced
+    static constexpr unsigned lmrMinMoveCount = 3;
+    static constexpr unsigned lmrTableSize = 64;
+
+    static constexpr unsigned maxSearchDepth = 64;
+    // depth searched if go came without any limit
+    static constexpr unsigned defaultDepth = 5;
+    // moves assumed to be left in the game if the GUI does not send movestogo
+    static constexpr int defaultMovesToGo = 30;
+    // time kept back for communication with the GUI
+    static constexpr int moveOverheadMs = 30;
+    // the main thread checks the limits every this many nodes
+    static constexpr uint64_t limitCheckInterval = 1024;
+    // minimum time between two periodic info reports within an iteration
+    static constexpr std::chrono::milliseconds infoInterval{1000};
+
+    /**
+     * Limits derived from the Clock when a search starts, the times count from searchStart.
+     * No new iteration is started after the soft limit, the hard limit aborts the running iteration.
+     */
+    struct SearchLimits {
+        std::chrono::milliseconds softTime{0};
+        std::chrono::milliseconds hardTime{0};
+        bool timed = false;
+        bool infinite = false;
+        unsigned depth = maxSearchDepth;
+        uint64_t nodes = 0;
+    };
+
+    TranspositionTable transpositionTable;
+    PruningParameters pruning;
+    SearchLimits limits;
+    // reset by ponderhit, so the time limits count from the moment the opponent played the expected move
+    std::atomic<std::chrono::steady_clock::time_point> searchStart;
+    // time limits are ignored until ponderhit
+    std::atomic<bool> pondering = false;
+    // the clock of the next search was already started by prepare, guarded by stopMutex
+    bool prepared = false;
+    // wakes a finished infinite or ponder search on stop or ponderhit
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    Move expectedReply = Move();
+    // start of the search as sent by the GUI, unlike searchStart not moved by ponderhit
+    std::chrono::steady_clock::time_point goTime;
+    std::chrono::steady_clock::time_point lastReport;
+    std::array<std::array<uint8_t, lmrTableSize>, lmrTableSize> lateMoveReductions{};
+    unsigned threadCount = 1;
+    std::unique_ptr<ThreadData[]> threads = std::make_unique<ThreadData[]>(1);
+    // set once the main thread finished, a limit is hit or a stop is requested, all threads abort their current iteration
+    std::atomic<bool> stopped = false;
+
+    void initLateMoveReductions();
+    [[nodiscard]] unsigned lateMoveReduction(unsigned depth, unsigned moveCount) const;
+    static SearchLimits computeLimits(const Clock& clock, bool pov);
+    /**
+     * Sets the start times and the ponder state, the caller holds stopMutex
+     */
+    void startClock(const Clock& clock);
+    /**
+     * @return true if the time limit is used up, never while pondering
+     */
+    [[nodiscard]] bool timeLimitReached(std::chrono::milliseconds limit) const;
+    /**
+     * @return the reply expected after bestMove, taken from the principal variation or the transposition table
+     */
+    Move findExpectedReply(State& state, Move bestMove, const std::vector<Move>& pv) const;
+    [[nodiscard]] uint64_t totalNodes() const;
+    /**
+     * Counts a node and, on the main thread, aborts the search once the hard deadline or node limit is reached
+     */
+    void countNode(ThreadData& thread);
+    /**
+     * Reports the counters and, after a finished iteration, its depth, value and principal variation
+     */
+    void reportProgress(unsigned depth = 0, std::optional<int> value = std::nullopt, const std::vector<Move>& pv = {});
+    void iterativeDeepeningSearch(State& state, Move& bestMove, std::vector<Move>& pv);
+    /**
+     * Lazy SMP helper: searches the same root as the main thread only to fill the shared transposition table.
+     * Odd helpers start one iteration deeper so the threads spread over different depths.
+     */
+    void helperSearch(State state, unsigned threadIndex);
+    /**
+     * Searches the root with a window around the value of the previous iteration and widens it on failure
+     */
+    int aspirationSearch(State& state, unsigned depth, int previousValue, std::vector<Move>& line, const std::vector<Move>& pv, ThreadData& thread);
+    /**
+     * @param status game over status of the position, as computed by the caller
+     * @return static evaluation relative to the side to move
+     */
+    int evaluate(const State& state, unsigned ply, NodeStatus status) const;
+    /**
+     * Resolves captures and promotions at the leaves so the static evaluation is only used in quiet positions.
+     * The side to move may stand pat unless it is in check, then all evasions are searched.
+     */
+    int quiescence(State &state, unsigned ply, int alpha, int beta, ThreadData& thread);
+    /**
+     * Negamax principal variation search, fail soft. All values are relative to the side to move.
+     * The first move is searched with the full window, all others with a null window and only re-searched if they
+     * turn out to be better. The best line found is left in the thread's pvTable row of ply.
+     */
+    int search(State &state, unsigned depth, unsigned ply, int alpha, int beta, std::vector<Move>::const_iterator pvBegin, std::vector<Move>::const_iterator pvEnd, ThreadData& thread);
 };
 }
@@ -0,0 +1,45 @@
+#include "MoveHistory.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace chess {
+    void MoveHistory::updateHistory(bool pov, Move move, int bonus) {
+        auto &entry = history[pov][move.fromSquare()][move.toSquare()];
+        // gravity keeps the scores bounded, large entries move less into their own direction
+        entry += bonus - entry * std::abs(bonus) / maxHistory;
+    }
+
+    void MoveHistory::onCutoff(bool pov, unsigned ply, unsigned depth, Move move, Move previousMove,
+                               const Move *triedQuietsBegin, const Move *triedQuietsEnd) {
+        if (ply < maxPly && killers[ply][0] != move) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = move;
+        }
+        if (previousMove != Move()) {
+            counterMoves[previousMove.fromSquare()][previousMove.toSquare()] = move;
+        }
+        int bonus = std::min<int>(depth * depth, maxHistory / 4);
+        updateHistory(pov, move, bonus);
+        for (auto it = triedQuietsBegin; it != triedQuietsEnd; it++) {
+            updateHistory(pov, *it, -bonus);
+        }
+    }
+
+    void MoveHistory::age() {
+        killers = {};
+        for (auto &side : history) {
+            for (auto &from : side) {
+                for (auto &entry : from) {
+                    entry /= 2;
+                }
+            }
+        }
+    }
+
+    void MoveHistory::clear() {
+        killers = {};
+        history = {};
+        counterMoves = {};
+    }
+}
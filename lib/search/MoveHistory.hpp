@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Move.hpp"
+
+namespace chess {
+    /**
+     * Move ordering memory of one search thread: two killer moves per ply, a butterfly history table indexed by
+     * side to move, from and to square, and the move that refuted each previous move (counter move).
+     * All tables are updated when a quiet move causes a cutoff.
+     */
+    class MoveHistory {
+    public:
+        static constexpr unsigned maxPly = 128;
+        // history scores stay within [-maxHistory, maxHistory]
+        static constexpr int maxHistory = 1 << 14;
+
+    private:
+        std::array<std::array<Move, 2>, maxPly> killers{};
+        std::array<std::array<std::array<int32_t, 64>, 64>, 2> history{};
+        std::array<std::array<Move, 64>, 64> counterMoves{};
+
+        void updateHistory(bool pov, Move move, int bonus);
+
+    public:
+        [[nodiscard]] bool isKiller(unsigned ply, Move move, unsigned slot) const {
+            return ply < maxPly && killers[ply][slot] == move;
+        }
+
+        [[nodiscard]] int historyScore(bool pov, Move move) const {
+            return history[pov][move.fromSquare()][move.toSquare()];
+        }
+
+        /**
+         * @return the quiet move that last refuted previousMove or Move() if there is none
+         */
+        [[nodiscard]] Move counterMove(Move previousMove) const {
+            return counterMoves[previousMove.fromSquare()][previousMove.toSquare()];
+        }
+
+        /**
+         * Records a quiet move that caused a cutoff.
+         * @param previousMove move leading to the node or Move() at the root
+         * @param triedQuiets quiet moves searched before the cutoff move, they are penalized
+         */
+        void onCutoff(bool pov, unsigned ply, unsigned depth, Move move, Move previousMove,
+                      const Move *triedQuietsBegin, const Move *triedQuietsEnd);
+
+        /**
+         * Forgets killers and scales down history between searches so old statistics fade out
+         */
+        void age();
+
+        void clear();
+    };
+}
@@ -0,0 +1,69 @@
+#include "MovePicker.hpp"
+
+#include <utility>
+
+namespace chess {
+    MovePicker::MovePicker(const Bitboard &board, const MoveList &moves, Move hashMove, const MoveHistory *history,
+                           unsigned ply, Move previousMove)
+            : moves(moves), history(history), ply(ply),
+              counterMove(history != nullptr && previousMove != Move() ? history->counterMove(previousMove) : Move()) {
+        for (std::size_t i = 0; i < moves.size(); i++) {
+            scores[i] = score(board, moves[i], hashMove);
+        }
+    }
+
+    int MovePicker::score(const Bitboard &board, Move move, Move hashMove) const {
+        if (move == hashMove) return hashMoveScore;
+        char victim = board.pieceAt(move.toSquare());
+        char attacker = board.pieceAt(move.fromSquare());
+        // en passant
+        if (victim == 0 && attacker == 'p' && move.fileDistance() != 0) victim = 'p';
+        char promotion = move.promotionPiece();
+        // under promotions are almost never better than quiet moves
+        if (promotion != 0 && promotion != 'q') return -captureScore + pieceValue(promotion);
+        if (victim == 0 && promotion == 0) {
+            if (history == nullptr) return 0;
+            // killers and the counter move rank directly below the captures
+            if (history->isKiller(ply, move, 0)) return captureScore - 1;
+            if (history->isKiller(ply, move, 1)) return captureScore - 2;
+            if (move == counterMove) return captureScore - 3;
+            return history->historyScore(board.getPov(), move);
+        }
+        // most valuable victim, least valuable attacker
+        return captureScore + 16 * pieceValue(victim) + 4 * pieceValue(promotion) - pieceValue(attacker);
+    }
+
+    bool MovePicker::next(Move &move) {
+        if (current == moves.size()) return false;
+        std::size_t best = current;
+        for (std::size_t i = current + 1; i < moves.size(); i++) {
+            if (scores[i] > scores[best]) best = i;
+        }
+        std::swap(moves[current], moves[best]);
+        std::swap(scores[current], scores[best]);
+        move = moves[current++];
+        return true;
+    }
+
+    bool MovePicker::isQuiet(const Bitboard &board, Move move) {
+        if (move.isPromotion() || board.pieceAt(move.toSquare()) != 0) return false;
+        // en passant
+        return board.pieceAt(move.fromSquare()) != 'p' || move.fileDistance() == 0;
+    }
+
+    int MovePicker::pieceValue(char piece) {
+        switch (piece) {
+            case 'p':
+                return 1;
+            case 'n':
+            case 'b':
+                return 3;
+            case 'r':
+                return 5;
+            case 'q':
+                return 9;
+            default:
+                return 0;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Bitboard.hpp"
+#include "Move.hpp"
+#include "MoveHistory.hpp"
+#include "MoveList.hpp"
+
+namespace chess {
+    /**
+     * Hands out the moves of a node best first. Every move is scored once into an integer key from the board alone,
+     * no child position is built. The next move is selected lazily, so moves after a cutoff are never sorted.
+     */
+    class MovePicker {
+    public:
+        static constexpr int hashMoveScore = 1 << 30;
+        static constexpr int captureScore = 1 << 20;
+
+    private:
+        MoveList moves;
+        std::array<int, MoveList::capacity> scores;
+        std::size_t current = 0;
+
+        const MoveHistory *history;
+        unsigned ply;
+        Move counterMove;
+
+        int score(const Bitboard &board, Move move, Move hashMove) const;
+
+    public:
+        /**
+         * @param moves legal moves of the board
+         * @param hashMove move tried first if it is part of moves
+         * @param history killers, counter moves and history scores used to order quiet moves, may be null
+         * @param previousMove move leading to the board, used to look up the counter move
+         */
+        MovePicker(const Bitboard &board, const MoveList &moves, Move hashMove = Move(),
+                   const MoveHistory *history = nullptr, unsigned ply = 0, Move previousMove = Move());
+
+        /**
+         * @param move set to the best remaining move
+         * @return false once all moves were handed out
+         */
+        bool next(Move &move);
+
+        [[nodiscard]] std::size_t size() const { return moves.size(); }
+
+        /**
+         * @return true if the move neither captures nor promotes
+         */
+        static bool isQuiet(const Bitboard &board, Move move);
+
+        /**
+         * @return cheap material value of a piece used for MVV-LVA ordering
+         */
+        static int pieceValue(char piece);
+    };
+}
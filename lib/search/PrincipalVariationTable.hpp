@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <span>
+
+#include "Move.hpp"
+
+namespace chess {
+    /**
+     * Triangular principal variation table of one search thread. Row ply holds the best line found from the node
+     * at that ply, a new best move copies the line of its child row behind it, so no memory is allocated while
+     * searching. Only the rows of the current search path are valid.
+     */
+    class PrincipalVariationTable {
+    public:
+        static constexpr unsigned maxPly = 128;
+
+    private:
+        std::array<std::array<Move, maxPly>, maxPly> moves{};
+        std::array<unsigned, maxPly> lengths{};
+
+    public:
+        /**
+         * Starts an empty line at a node, called before the node returns in any way
+         */
+        void clear(unsigned ply) {
+            assert(ply < maxPly);
+            lengths[ply] = 0;
+        }
+
+        /**
+         * The line of ply becomes move followed by the line of the child at ply + 1
+         */
+        void update(unsigned ply, Move move) {
+            assert(ply < maxPly);
+            unsigned childLength = ply + 1 < maxPly ? std::min(lengths[ply + 1], maxPly - 1) : 0;
+            moves[ply][0] = move;
+            for (unsigned i = 0; i < childLength; i++) {
+                moves[ply][i + 1] = moves[ply + 1][i];
+            }
+            lengths[ply] = childLength + 1;
+        }
+
+        /**
+         * The line of ply consists of move only, used if the node was cut without searching its children
+         */
+        void set(unsigned ply, Move move) {
+            assert(ply < maxPly);
+            moves[ply][0] = move;
+            lengths[ply] = 1;
+        }
+
+        [[nodiscard]] std::span<const Move> line(unsigned ply) const {
+            return {moves[ply].data(), lengths[ply]};
+        }
+
+        /**
+         * @return first move of the line of ply or Move() if it is empty
+         */
+        [[nodiscard]] Move bestMove(unsigned ply) const {
+            return lengths[ply] > 0 ? moves[ply][0] : Move();
+        }
+    };
+}
@@ -1,16 +1,86 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
 #include <Move.hpp>
 #include <State.hpp>
 #include <Clock.hpp>
 #include <eval/Evaluator.hpp>
+#include <eval/Score.hpp>
 
 namespace chess{
+/**
+ * Integer option of a search, announced to the GUI as UCI spin option
+ */
+struct SearchOption {
+    std::string name;
+    int defaultValue;
+    int min;
+    int max;
+};
+
+/**
+ * Progress of a running search, sent to the GUI as UCI info line.
+ * Periodic updates between iterations only carry the counters, depth, score and pv are left empty.
+ */
+struct SearchInfo {
+    unsigned depth = 0;
+    unsigned selectiveDepth = 0;
+    // from the point of view of the side to move
+    std::optional<Score> score;
+    uint64_t nodes = 0;
+    std::chrono::milliseconds time{0};
+    // permille of the transposition table used by the current search
+    unsigned hashfull = 0;
+    std::vector<Move> pv;
+};
+
 class Search {
 protected:
     Evaluator& evaluator;
+    std::function<void(const SearchInfo&)> infoCallback;
+
+    void report(const SearchInfo& info) const {
+        if (infoCallback) infoCallback(info);
+    }
 public:
-    virtual Move findNextMove(State& state,const Clock& clock) = 0;
+    /**
+     * @param callback called from the search thread whenever the search has progress to report
+     */
+    void setInfoCallback(std::function<void(const SearchInfo&)> callback) { infoCallback = std::move(callback); }
+    /**
+     * @param stopToken once a stop is requested the search returns its best move as soon as possible
+     */
+    virtual Move findNextMove(State& state, const Clock& clock, std::stop_token stopToken) = 0;
+    Move findNextMove(State& state, const Clock& clock) { return findNextMove(state, clock, {}); }
+    /**
+     * Starts the clock of the next findNextMove on the calling thread, so a ponderhit sent right after go
+     * cannot be overtaken by the search thread starting up. Without it findNextMove starts the clock itself.
+     */
+    virtual void prepare(const Clock& clock) { (void) clock; }
+    /**
+     * The opponent played the expected move, the running ponder search continues as a normal search
+     * with its time limits counted from now.
+     */
+    virtual void ponderhit() {}
+    /**
+     * @return expected reply to the move returned by the last findNextMove, Move() if there is none
+     */
+    [[nodiscard]] virtual Move ponderMove() const { return Move(); }
+    [[nodiscard]] virtual std::vector<SearchOption> options() const { return {}; }
+    /**
+     * @return false if the search has no option with this name
+     */
+    virtual bool setOption(const std::string& name, int value) { (void) name; (void) value; return false; }
+    /**
+     * Forget everything learned from previous searches
+     */
+    virtual void newGame() {}
+    virtual ~Search() = default;
     Search(Evaluator& evaluator) : evaluator(evaluator) {};
 };
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <optional>
+
+#include "MoveList.hpp"
+#include "MovePicker.hpp"
+
+namespace chess {
+    /**
+     * Working memory of the node at one ply: its legal moves, generated once with the game over test, the move
+     * picker ordering them, the quiet moves searched without a cutoff and the static evaluation.
+     * Killers are kept per ply in MoveHistory and the undo information of the played moves in State.
+     */
+    struct SearchFrame {
+        MoveList moves;
+        std::optional<MovePicker> picker;
+        MoveList triedQuiets;
+        int staticValue = 0;
+    };
+
+    /**
+     * Ply indexed frames of one search thread, allocated once with the thread data so the recursion neither
+     * touches the heap nor keeps kilobytes of move lists on the native stack.
+     */
+    class SearchStack {
+    public:
+        static constexpr unsigned maxPly = 128;
+
+    private:
+        std::array<SearchFrame, maxPly> frames;
+
+    public:
+        SearchFrame &operator[](unsigned ply) {
+            assert(ply < maxPly);
+            return frames[ply];
+        }
+    };
+}
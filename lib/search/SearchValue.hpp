@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "eval/Score.hpp"
+
+namespace chess {
+    /**
+     * Integer scores used inside the search. Values are relative to the side to move (negamax) and mate scores
+     * count the plies from the root, so shorter mates are preferred and windows can be moved by arithmetic.
+     */
+    class SearchValue {
+    public:
+        static constexpr int draw = 0;
+        static constexpr int mate = 32000;
+        static constexpr int infinity = mate + 1;
+        static constexpr int maxCentipawns = 30000;
+        // mates further away than this many plies cannot be represented
+        static constexpr int maxMatePly = 1000;
+
+        static constexpr int mateIn(unsigned ply) { return mate - static_cast<int>(ply); }
+
+        static constexpr int matedIn(unsigned ply) { return -mate + static_cast<int>(ply); }
+
+        static constexpr bool isMate(int value) { return std::abs(value) >= mate - maxMatePly; }
+
+        /**
+         * Converts an evaluator score (white's point of view, mate only at the mated node)
+         * @param pov side to move of the evaluated position
+         * @param ply distance of the evaluated position to the root
+         */
+        static int fromScore(const Score &score, bool pov, unsigned ply) {
+            if (score.isMate) {
+                return (score.value > 0) == pov ? mateIn(ply) : matedIn(ply);
+            }
+            return std::clamp(pov ? score.value : -score.value, -maxCentipawns, maxCentipawns);
+        }
+
+        /**
+         * Converts a search value at the root back to white's point of view, mates are counted in moves
+         * @param pov side to move at the root
+         */
+        static Score toScore(int value, bool pov) {
+            int whiteValue = pov ? value : -value;
+            if (!isMate(value)) return Score(whiteValue);
+            int moves = std::max(1, (mate - std::abs(value) + 1) / 2);
+            return {true, whiteValue > 0 ? moves : -moves};
+        }
+
+        /**
+         * Mate values in the transposition table are stored relative to the stored node instead of the root
+         */
+        static constexpr int toTranspositionTable(int value, unsigned ply) {
+            if (value >= mate - maxMatePly) return value + static_cast<int>(ply);
+            if (value <= -mate + maxMatePly) return value - static_cast<int>(ply);
+            return value;
+        }
+
+        static constexpr int fromTranspositionTable(int value, unsigned ply) {
+            if (value >= mate - maxMatePly) return value - static_cast<int>(ply);
+            if (value <= -mate + maxMatePly) return value + static_cast<int>(ply);
+            return value;
+        }
+    };
+}
@@ -0,0 +1,106 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+namespace chess {
+    TranspositionTable::TranspositionTable(std::size_t megabytes) {
+        resize(megabytes);
+    }
+
+    void TranspositionTable::resize(std::size_t megabytes) {
+        std::size_t requested = std::max<std::size_t>(1, megabytes * 1024 * 1024 / sizeof(Bucket));
+        bucketCount = std::bit_floor(requested);
+        buckets = std::make_unique<Bucket[]>(bucketCount);
+        clear();
+    }
+
+    void TranspositionTable::clear() {
+        for (std::size_t i = 0; i < bucketCount; i++) {
+            for (unsigned slot = 0; slot < bucketSize; slot++) {
+                buckets[i].keys[slot].store(0, std::memory_order_relaxed);
+                buckets[i].data[slot].store(0, std::memory_order_relaxed);
+            }
+        }
+        age = 0;
+    }
+
+    void TranspositionTable::newSearch() {
+        age = (age + 1) & 0x3fu;
+    }
+
+    bool TranspositionTable::probe(uint64_t key, Entry &entry) const {
+        Bucket &bucket = bucketFor(key);
+        for (unsigned slot = 0; slot < bucketSize; slot++) {
+            uint64_t data = bucket.data[slot].load(std::memory_order_relaxed);
+            uint64_t storedKey = bucket.keys[slot].load(std::memory_order_relaxed);
+            if ((storedKey ^ data) != key) continue;
+            entry = unpack(data);
+            if (entry.bound == Bound::None) return false;
+            return true;
+        }
+        return false;
+    }
+
+    void TranspositionTable::store(uint64_t key, Move move, int value, unsigned depth, Bound bound) {
+        assert(value >= std::numeric_limits<int16_t>::min() && value <= std::numeric_limits<int16_t>::max());
+        Bucket &bucket = bucketFor(key);
+        unsigned replace = 0;
+        int worstValue = 0;
+        for (unsigned slot = 0; slot < bucketSize; slot++) {
+            uint64_t data = bucket.data[slot].load(std::memory_order_relaxed);
+            uint64_t storedKey = bucket.keys[slot].load(std::memory_order_relaxed);
+            if ((storedKey ^ data) == key) {
+                Entry old = unpack(data);
+                // a shallower bound, e.g. from a reduced re-search, must not replace a deeper result of this search
+                if (bound != Bound::Exact && old.depth > depth && ageOf(data) == age) return;
+                // keep the best move of a previous search if this one did not find any
+                if (move == Move() && old.move != Move()) move = old.move;
+                replace = slot;
+                break;
+            }
+            // prefer replacing shallow entries and entries from older searches
+            Entry old = unpack(data);
+            int ageDistance = (age - ageOf(data)) & 0x3f;
+            int value = old.depth - 8 * ageDistance;
+            if (slot == 0 || value < worstValue) {
+                worstValue = value;
+                replace = slot;
+            }
+        }
+        uint64_t data = pack(move, static_cast<int16_t>(value), depth, bound, age);
+        bucket.data[replace].store(data, std::memory_order_relaxed);
+        bucket.keys[replace].store(key ^ data, std::memory_order_relaxed);
+    }
+
+    unsigned TranspositionTable::hashfull() const {
+        unsigned used = 0;
+        std::size_t sampled = std::min<std::size_t>(bucketCount, 1000 / bucketSize);
+        for (std::size_t i = 0; i < sampled; i++) {
+            for (unsigned slot = 0; slot < bucketSize; slot++) {
+                uint64_t data = buckets[i].data[slot].load(std::memory_order_relaxed);
+                if (unpack(data).bound != Bound::None && ageOf(data) == age) used++;
+            }
+        }
+        return used * 1000 / (sampled * bucketSize);
+    }
+
+    uint64_t TranspositionTable::pack(Move move, int16_t value, unsigned depth, Bound bound, uint8_t age) {
+        return static_cast<uint64_t>(move.raw())
+               | static_cast<uint64_t>(static_cast<uint16_t>(value)) << 16u
+               | static_cast<uint64_t>(std::min(depth, 255u)) << 32u
+               | static_cast<uint64_t>(bound) << 40u
+               | static_cast<uint64_t>(age & 0x3fu) << 42u;
+    }
+
+    TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+        Entry entry{};
+        entry.move = Move::fromRaw(data & 0xffffu);
+        entry.value = static_cast<int16_t>((data >> 16u) & 0xffffu);
+        entry.depth = (data >> 32u) & 0xffu;
+        entry.bound = static_cast<Bound>((data >> 40u) & 0x3u);
+        return entry;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Move.hpp"
+
+namespace chess {
+    /**
+     * Hash table of search results shared between searches (and threads).
+     * Each entry is two 64 bit words, the key is stored xor-ed with the data word so a torn write by a concurrent
+     * thread shows up as a key mismatch instead of a corrupted hit. Four entries form a cache line sized bucket.
+     */
+    class TranspositionTable {
+    public:
+        enum class Bound : uint8_t {
+            None = 0,
+            // score is an upper bound, the search failed low
+            Upper = 1,
+            // score is a lower bound, the search failed high
+            Lower = 2,
+            Exact = 3
+        };
+
+        struct Entry {
+            Move move;
+            // search value relative to the side to move, see SearchValue::toTranspositionTable
+            int16_t value;
+            uint8_t depth;
+            Bound bound;
+        };
+
+        static constexpr std::size_t defaultSizeMb = 16;
+
+    private:
+        static constexpr unsigned bucketSize = 4;
+
+        struct alignas(64) Bucket {
+            std::atomic<uint64_t> keys[bucketSize];
+            std::atomic<uint64_t> data[bucketSize];
+        };
+
+        std::unique_ptr<Bucket[]> buckets;
+        std::size_t bucketCount = 0;
+        uint8_t age = 0;
+
+        [[nodiscard]] Bucket &bucketFor(uint64_t key) const { return buckets[key & (bucketCount - 1)]; }
+
+        static uint64_t pack(Move move, int16_t value, unsigned depth, Bound bound, uint8_t age);
+
+        static Entry unpack(uint64_t data);
+
+        static uint8_t ageOf(uint64_t data) { return (data >> 42u) & 0x3fu; }
+
+    public:
+        explicit TranspositionTable(std::size_t megabytes = defaultSizeMb);
+
+        /**
+         * Reallocates the table with the largest power of two number of buckets fitting into the given size.
+         * All entries are lost.
+         */
+        void resize(std::size_t megabytes);
+
+        void clear();
+
+        /**
+         * Marks the start of a new search, entries of older searches are replaced first
+         */
+        void newSearch();
+
+        /**
+         * @param entry filled with the stored result if the key was found
+         * @return true if the key was found
+         */
+        bool probe(uint64_t key, Entry &entry) const;
+
+        /**
+         * Replaces the entry of the same key unless it is deeper, from the current search and the new one is only
+         * a bound. Otherwise the shallowest, oldest entry of the bucket is replaced.
+         */
+        void store(uint64_t key, Move move, int value, unsigned depth, Bound bound);
+
+        /**
+         * @return permille of sampled entries written during the current search
+         */
+        [[nodiscard]] unsigned hashfull() const;
+    };
+}
@@ -1,9 +1,13 @@
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include "UCI.hpp"
+#include "Perft.hpp"
 
 namespace chess {
     void UCI::start() {
+        search.setInfoCallback([this](const SearchInfo &info) { printInfo(info); });
         std::string lineStr;
         while (!quitting && getline(instream,lineStr)) {
             line = std::istringstream(lineStr);
@@ -14,17 +18,29 @@ namespace chess {
             else if(cmd == "debug") debug();
             else if(cmd == "position") position();
             else if(cmd == "isready") isready();
+            else if(cmd == "setoption") setoption();
+            else if(cmd == "ucinewgame") ucinewgame();
             else if(cmd == "go") go();
+            else if(cmd == "stop") stop();
+            else if(cmd == "ponderhit") ponderhit();
             else if(cmd == "quit") quit();
             else{
                 _unknown();
             }
         }
+        // end of input is treated like quit
+        stop();
     }
 
     void chess::UCI::uci() {
         outstream << "id name MChessTS" << std::endl;
         outstream << "id author waegemans" << std::endl;
+        for (const auto &option : search.options()) {
+            outstream << "option name " << option.name << " type spin default " << option.defaultValue
+                      << " min " << option.min << " max " << option.max << std::endl;
+        }
+        // pondering is controlled by the GUI through go ponder, the option only announces support
+        outstream << "option name Ponder type check default false" << std::endl;
         outstream << "uciok" << std::endl;
     }
 
@@ -33,11 +49,29 @@ namespace chess {
     }
 
     void UCI::isready() {
+        std::lock_guard lock(outputMutex);
         outstream << "readyok" << std::endl;
     }
 
     void UCI::setoption() {
-        _notImplemented();
+        waitForSearch();
+        // setoption name <id> [value <x>], the name may contain spaces
+        std::string token, name, value;
+        line >> token;
+        if (token != "name") {
+            _unknown();
+            return;
+        }
+        while (line >> token && token != "value") {
+            name += (name.empty() ? "" : " ") + token;
+        }
+        line >> value;
+        if (name == "Ponder") return;
+        try {
+            if (search.setOption(name, std::stoi(value))) return;
+        } catch (const std::logic_error &) {
+        }
+        std::cerr << "info unknown option " << name << std::endl;
     }
 
     void UCI::registerUCI() {
@@ -45,10 +79,13 @@ namespace chess {
     }
 
     void UCI::ucinewgame() {
-        _notImplemented();
+        waitForSearch();
+        search.newGame();
+        state.reset();
     }
 
     void UCI::position() {
+        waitForSearch();
         std::string mode;
         line >> mode;
         if (mode == "fen"){
@@ -69,20 +106,76 @@ namespace chess {
     }
 
     void UCI::go() {
-        auto nextMove = search.findNextMove(state, {0,0,5000,5000});
-        outstream << "bestmove " << nextMove.toUCI() << std::endl;
+        Clock clock{0, 0, 0, 0};
+        std::string token;
+        while (line >> token) {
+            if (token == "perft") {
+                unsigned depth = 1;
+                line >> depth;
+                waitForSearch();
+                Perft::run(outstream, state.getCurrentBitboard(), depth);
+                return;
+            }
+            if (token == "wtime") line >> clock.white_time_ms;
+            else if (token == "btime") line >> clock.black_time_ms;
+            else if (token == "winc") line >> clock.white_increment_ms;
+            else if (token == "binc") line >> clock.black_increment_ms;
+            else if (token == "movestogo") line >> clock.moves_to_go;
+            else if (token == "movetime") line >> clock.move_time_ms;
+            else if (token == "depth") line >> clock.depth;
+            else if (token == "nodes") line >> clock.nodes;
+            else if (token == "infinite") clock.infinite = true;
+            else if (token == "ponder") clock.ponder = true;
+        }
+        waitForSearch();
+        search.prepare(clock);
+        // the search works on its own copy, so the input loop stays responsive
+        searchThread = std::jthread([this, clock, searchState = state](std::stop_token stopToken) mutable {
+            auto nextMove = search.findNextMove(searchState, clock, stopToken);
+            auto ponderMove = search.ponderMove();
+            std::lock_guard lock(outputMutex);
+            outstream << "bestmove " << nextMove.toUCI();
+            if (ponderMove != Move()) outstream << " ponder " << ponderMove.toUCI();
+            outstream << std::endl;
+        });
     }
 
     void UCI::quit() {
+        stop();
         quitting = true;
     }
 
     void UCI::stop() {
-        _notImplemented();
+        if (searchThread.joinable()) {
+            searchThread.request_stop();
+            searchThread.join();
+        }
+    }
+
+    void UCI::waitForSearch() {
+        if (searchThread.joinable()) {
+            searchThread.join();
+        }
+    }
+
+    void UCI::printInfo(const SearchInfo &info) {
+        std::lock_guard lock(outputMutex);
+        outstream << "info";
+        if (info.depth > 0) outstream << " depth " << info.depth << " seldepth " << info.selectiveDepth;
+        if (info.score) outstream << " score " << (info.score->isMate ? "mate " : "cp ") << info.score->value;
+        auto milliseconds = static_cast<uint64_t>(info.time.count());
+        outstream << " nodes " << info.nodes << " nps " << info.nodes * 1000 / std::max<uint64_t>(milliseconds, 1)
+                  << " time " << milliseconds << " hashfull " << info.hashfull;
+        if (!info.pv.empty()) {
+            outstream << " pv";
+            for (auto move : info.pv) outstream << " " << move.toUCI();
+        }
+        outstream << std::endl;
     }
 
     void UCI::ponderhit() {
-        _notImplemented();
+        // the ponder search keeps running, only its time limits start now
+        search.ponderhit();
     }
 
     void UCI::_notImplemented() {
@@ -4,6 +4,8 @@
 #include <istream>
 #include <string_view>
 #include <sstream>
+#include <mutex>
+#include <thread>
 #include <search/Search.hpp>
 #include "State.hpp"
 
@@ -20,6 +22,10 @@ namespace chess {
         State state;
         Search& search;
         std::istringstream line;
+        // guards outstream, the search thread prints info and bestmove while commands are still answered
+        std::mutex outputMutex;
+        // declared last so a running search is stopped and joined before the members it uses are destroyed
+        std::jthread searchThread;
 
 
         void uci();
@@ -44,6 +50,16 @@ namespace chess {
 
         void quit();
 
+        /**
+         * Blocks until the running search, if any, printed its best move
+         */
+        void waitForSearch();
+
+        /**
+         * Prints the progress reported by the search thread
+         */
+        void printInfo(const SearchInfo &info);
+
         void _notImplemented();
         void _unknown();
 
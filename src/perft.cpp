@@ -0,0 +1,27 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "Bitboard.hpp"
+#include "Perft.hpp"
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <depth> [startpos | fen]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    unsigned depth = std::stoul(argv[1]);
+
+    std::string fen;
+    for (int i = 2; i < argc; i++) {
+        if (!fen.empty()) fen += ' ';
+        fen += argv[i];
+    }
+
+    chess::Bitboard bitboard;
+    if (fen.empty() || fen == "startpos") {
+        bitboard.startpos();
+    } else {
+        bitboard.parseFEN(fen);
+    }
+    chess::Perft::run(std::cout, bitboard, depth);
+}
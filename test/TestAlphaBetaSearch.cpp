@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "search/AlphaBetaSearch.hpp"
 #include "eval/PiecePositionEvaluator.hpp"
 
@@ -29,3 +35,184 @@ TEST(TestAlphaBetaSearch, MateInTree) {
 }
 
 
+
+TEST(TestAlphaBetaSearch, LazySMP) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    EXPECT_TRUE(alphaBeta.setOption("Threads", 4));
+    state.parseFen("1k6/3q1Q2/1K6/8/8/8/8/8 w - - 0 1");
+    EXPECT_EQ(alphaBeta.findNextMove(state, {0, 0, 1000, 1000}).toUCI(), "f7d7");
+    state.parseFen("6k1/8/6K1/8/3R4/8/8/8 w - - 0 1");
+    EXPECT_EQ(alphaBeta.findNextMove(state, {0, 0, 1000, 1000}).toUCI(), "d4d8");
+}
+
+TEST(TestAlphaBetaSearch, PruningOptions) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    EXPECT_TRUE(alphaBeta.setOption("FutilityMargin", 0));
+    EXPECT_TRUE(alphaBeta.setOption("ReverseFutilityMargin", 0));
+    EXPECT_TRUE(alphaBeta.setOption("LMRBase", 0));
+    EXPECT_TRUE(alphaBeta.setOption("LMRDivisor", 1000));
+    EXPECT_FALSE(alphaBeta.setOption("NoSuchOption", 1));
+    state.parseFen("8/kp4pp/6q1/1p6/2p3Q1/N1P2P2/PP1rr2P/3R1R1K b - - 13 30");
+    EXPECT_EQ(alphaBeta.findNextMove(state, {0, 0, 1000, 1000}).toUCI(), "e2h2");
+}
+
+TEST(TestAlphaBetaSearch, Limits) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    state.parseFen("6k1/8/6K1/8/3R4/8/8/8 w - - 0 1");
+    chess::Clock depthLimit{0, 0, 0, 0};
+    depthLimit.depth = 1;
+    EXPECT_EQ(alphaBeta.findNextMove(state, depthLimit).toUCI(), "d4d8");
+
+    state.reset();
+    chess::Clock nodeLimit{0, 0, 0, 0};
+    nodeLimit.nodes = 1;
+    EXPECT_NE(alphaBeta.findNextMove(state, nodeLimit), chess::Move(0, 0));
+
+    // even a very long iteration has to be aborted at the deadline
+    chess::Clock moveTime{0, 0, 0, 0};
+    moveTime.move_time_ms = 100;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_NE(alphaBeta.findNextMove(state, moveTime), chess::Move(0, 0));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+}
+
+TEST(TestAlphaBetaSearch, LowClock) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    state.reset();
+    // less than a millisecond per move to go, the deadline must not round down to no deadline
+    chess::Clock lowClock{50, 50, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_NE(alphaBeta.findNextMove(state, lowClock), chess::Move(0, 0));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+}
+
+TEST(TestAlphaBetaSearch, NodeLimit) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    uint64_t nodes = 0;
+    alphaBeta.setInfoCallback([&](const chess::SearchInfo &info) { nodes = info.nodes; });
+    state.reset();
+    chess::Clock nodeLimit{0, 0, 0, 0};
+    nodeLimit.nodes = 50000;
+    EXPECT_NE(alphaBeta.findNextMove(state, nodeLimit), chess::Move(0, 0));
+    // the limit is polled every limitCheckInterval nodes, so the search stops shortly after reaching it
+    EXPECT_GE(nodes, nodeLimit.nodes);
+    EXPECT_LT(nodes, 2 * nodeLimit.nodes);
+}
+
+TEST(TestAlphaBetaSearch, InfiniteUntilStopped) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    EXPECT_TRUE(alphaBeta.setOption("Threads", 2));
+    // mate in one is found immediately, the infinite search still has to wait for the stop
+    state.parseFen("6k1/8/6K1/8/3R4/8/8/8 w - - 0 1");
+    chess::Clock infinite{0, 0, 0, 0};
+    infinite.infinite = true;
+    std::stop_source stopSource;
+    std::atomic<bool> done = false;
+    chess::Move bestMove;
+    std::thread searcher([&] {
+        bestMove = alphaBeta.findNextMove(state, infinite, stopSource.get_token());
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(done);
+    stopSource.request_stop();
+    searcher.join();
+    EXPECT_EQ(bestMove.toUCI(), "d4d8");
+
+    // a stop requested before the search starts returns right away
+    state.reset();
+    EXPECT_NE(alphaBeta.findNextMove(state, infinite, stopSource.get_token()), chess::Move(0, 0));
+}
+
+TEST(TestAlphaBetaSearch, PonderUntilPonderhit) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    state.parseFen("6k1/8/6K1/8/3R4/8/8/8 w - - 0 1");
+    chess::Clock ponder{0, 0, 0, 0};
+    ponder.move_time_ms = 60000;
+    ponder.ponder = true;
+    std::atomic<bool> done = false;
+    chess::Move bestMove;
+    std::thread searcher([&] {
+        bestMove = alphaBeta.findNextMove(state, ponder);
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(done);
+    // the mate was already found, the search returns as soon as it becomes a normal search
+    alphaBeta.ponderhit();
+    searcher.join();
+    EXPECT_EQ(bestMove.toUCI(), "d4d8");
+}
+
+TEST(TestAlphaBetaSearch, PonderhitBeforeSearchStarts) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    state.parseFen("6k1/8/6K1/8/3R4/8/8/8 w - - 0 1");
+    chess::Clock ponder{0, 0, 0, 0};
+    ponder.move_time_ms = 60000;
+    ponder.ponder = true;
+    // the GUI sends ponderhit right after go ponder, before the search thread got to run
+    alphaBeta.prepare(ponder);
+    alphaBeta.ponderhit();
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(alphaBeta.findNextMove(state, ponder).toUCI(), "d4d8");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+}
+
+TEST(TestAlphaBetaSearch, PonderMove) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    state.reset();
+    chess::Clock clock{0, 0, 0, 0};
+    clock.depth = 4;
+    auto bestMove = alphaBeta.findNextMove(state, clock);
+    auto ponderMove = alphaBeta.ponderMove();
+    state.pushMove(bestMove);
+    auto replies = state.getCurrentBitboard().legalMoves();
+    EXPECT_NE(std::find(replies.begin(), replies.end(), ponderMove), replies.end());
+}
+
+TEST(TestAlphaBetaSearch, ReportsIterations) {
+    chess::State state;
+    chess::PiecePositionEvaluator evaluator;
+    chess::AlphaBetaSearch alphaBeta(evaluator);
+    std::vector<chess::SearchInfo> infos;
+    alphaBeta.setInfoCallback([&](const chess::SearchInfo &info) { infos.push_back(info); });
+    state.reset();
+    chess::Clock clock{0, 0, 0, 0};
+    clock.depth = 3;
+    auto bestMove = alphaBeta.findNextMove(state, clock);
+    ASSERT_EQ(infos.size(), 3u);
+    for (unsigned i = 0; i < infos.size(); i++) {
+        EXPECT_EQ(infos[i].depth, i + 1);
+        EXPECT_GE(infos[i].selectiveDepth, infos[i].depth);
+        ASSERT_TRUE(infos[i].score.has_value());
+        EXPECT_FALSE(infos[i].score->isMate);
+        EXPECT_FALSE(infos[i].pv.empty());
+    }
+    EXPECT_EQ(infos.back().pv.front(), bestMove);
+    EXPECT_GT(infos.back().nodes, infos.front().nodes);
+
+    // mate scores count moves from the side to move's point of view, black mates in one here
+    infos.clear();
+    state.parseFen("8/8/8/8/3r4/6k1/8/6K1 b - - 0 1");
+    alphaBeta.findNextMove(state, clock);
+    ASSERT_FALSE(infos.empty());
+    EXPECT_EQ(infos.back().score, chess::Score(true, 1));
+}
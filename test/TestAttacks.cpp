@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include "Attacks.hpp"
+#include "Move.hpp"
+
+namespace {
+    unsigned square(std::string_view name) {
+        return chess::Move(std::string(name) + "a1").fromSquare();
+    }
+
+    uint64_t mask(std::initializer_list<std::string_view> names) {
+        uint64_t result = 0;
+        for (auto name : names) result |= 1ull << square(name);
+        return result;
+    }
+}
+
+TEST(TestAttacks, rookEmptyBoard) {
+    EXPECT_EQ(chess::Attacks::rook(square("a1"), 0), 0x80808080808080ffull ^ mask({"a1"}));
+}
+
+TEST(TestAttacks, rookBlocked) {
+    uint64_t occupied = mask({"d4", "d6", "b4", "g4", "d2", "a1"});
+    EXPECT_EQ(chess::Attacks::rook(square("d4"), occupied),
+              mask({"d5", "d6", "c4", "b4", "e4", "f4", "g4", "d3", "d2"}));
+}
+
+TEST(TestAttacks, bishopBlocked) {
+    uint64_t occupied = mask({"d4", "f6", "b2", "e3"});
+    EXPECT_EQ(chess::Attacks::bishop(square("d4"), occupied),
+              mask({"e5", "f6", "c5", "b6", "a7", "c3", "b2", "e3"}));
+}
+
+TEST(TestAttacks, queenCorner) {
+    EXPECT_EQ(std::popcount(chess::Attacks::queen(square("h8"), 0)), 21);
+}
+
+TEST(TestAttacks, between) {
+    EXPECT_EQ(chess::Attacks::between(square("a1"), square("d4")), mask({"b2", "c3"}));
+    EXPECT_EQ(chess::Attacks::between(square("e8"), square("e5")), mask({"e7", "e6"}));
+    EXPECT_EQ(chess::Attacks::between(square("a1"), square("b3")), 0ull);
+    EXPECT_EQ(chess::Attacks::between(square("a1"), square("b2")), 0ull);
+}
+
+TEST(TestAttacks, line) {
+    EXPECT_EQ(chess::Attacks::line(square("c1"), square("e1")), 0xffull);
+    EXPECT_EQ(chess::Attacks::line(square("a1"), square("h8")), 0x0102040810204080ull);
+    EXPECT_EQ(chess::Attacks::line(square("b2"), square("d4")), 0x0102040810204080ull);
+    EXPECT_EQ(chess::Attacks::line(square("a1"), square("b3")), 0ull);
+}
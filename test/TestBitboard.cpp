@@ -382,3 +382,132 @@ TEST(TestBitboard, enPassantWeakPin) {
 }
 
 
+
+TEST(TestBitboard, unmakeMoveRestoresPosition) {
+    for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                     "8/8/8/4k3/1p1pPp2/8/8/1K6 b - e3 0 1"}) {
+        auto bitboard = chess::Bitboard();
+        bitboard.parseFEN(fen);
+        auto position = bitboard.position();
+        bool pov = bitboard.getPov();
+        for (auto move : bitboard.legalMoves()) {
+            auto undo = bitboard.applyMoveSelf(move);
+            bitboard.unmakeMove(undo);
+            EXPECT_TRUE(bitboard.position() == position) << fen << " " << move.toUCI();
+            EXPECT_EQ(bitboard.getPov(), pov);
+            EXPECT_EQ(bitboard.getHalfMoveCounter(), 0);
+        }
+    }
+}
+
+TEST(TestBitboard, unmakeEnPassant) {
+    auto bitboard = chess::Bitboard();
+    bitboard.parseFEN("8/8/8/4k3/1p1pPp2/8/8/1K6 b - e3 0 1");
+    auto undo = bitboard.applyMoveSelf(chess::Move("d4e3"));
+    EXPECT_EQ(undo.captured, 'p');
+    EXPECT_EQ(bitboard.pieceAt(chess::Move("e4e4").fromSquare()), 0);
+    bitboard.unmakeMove(undo);
+    EXPECT_EQ(bitboard.pieceAt(chess::Move("e4e4").fromSquare()), 'p');
+    EXPECT_EQ(bitboard.getEnPassantFile(), 3);
+    EXPECT_FALSE(bitboard.getPov());
+}
+
+namespace {
+    bool isCaptureOrPromotion(const chess::Bitboard &bitboard, chess::Move move) {
+        if (move.isPromotion() || bitboard.pieceAt(move.toSquare()) != 0) return true;
+        // en passant
+        return bitboard.pieceAt(move.fromSquare()) == 'p' && move.fileDistance() != 0;
+    }
+
+    void expectCaptureMovesMatch(chess::Bitboard &bitboard, unsigned depth) {
+        auto legalMoves = bitboard.legalMoves();
+        auto captureMoves = bitboard.captureMoves();
+        size_t expected = 0;
+        for (auto move : legalMoves) {
+            if (!isCaptureOrPromotion(bitboard, move)) continue;
+            expected++;
+            MOVE_IN(captureMoves, move.toUCI());
+        }
+        EXPECT_EQ(captureMoves.size(), expected);
+        if (depth == 0) return;
+        for (auto move : legalMoves) {
+            auto undo = bitboard.applyMoveSelf(move);
+            expectCaptureMovesMatch(bitboard, depth - 1);
+            bitboard.unmakeMove(undo);
+        }
+    }
+}
+
+namespace {
+    void expectCountsMatch(chess::Bitboard &bitboard, unsigned depth) {
+        auto legalMoves = bitboard.legalMoves();
+        EXPECT_EQ(bitboard.countLegalMoves(), legalMoves.size());
+        EXPECT_EQ(bitboard.hasLegalMove(), !legalMoves.empty());
+        if (depth == 0) return;
+        for (auto move : legalMoves) {
+            auto undo = bitboard.applyMoveSelf(move);
+            expectCountsMatch(bitboard, depth - 1);
+            bitboard.unmakeMove(undo);
+        }
+    }
+}
+
+TEST(TestBitboard, countAndHasLegalMoveMatchLegalMoves) {
+    for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                     "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                     "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"}) {
+        auto bitboard = chess::Bitboard();
+        bitboard.parseFEN(fen);
+        expectCountsMatch(bitboard, 2);
+    }
+    auto bitboard = chess::Bitboard();
+    // checkmate and stalemate
+    bitboard.parseFEN("4k3/4Q3/4K3/8/8/8/8/8 b - - 0 1");
+    EXPECT_FALSE(bitboard.hasLegalMove());
+    EXPECT_EQ(bitboard.countLegalMoves(), 0u);
+    bitboard.parseFEN("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    EXPECT_FALSE(bitboard.hasLegalMove());
+    // only the pawn can move, promoting to any of four pieces
+    bitboard.parseFEN("7k/5Q2/7K/8/8/8/p7/8 b - - 0 1");
+    EXPECT_TRUE(bitboard.hasLegalMove());
+    EXPECT_EQ(bitboard.countLegalMoves(), 4u);
+}
+
+TEST(TestBitboard, captureMovesAreLegalCaptures) {
+    for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                     "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                     "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"}) {
+        auto bitboard = chess::Bitboard();
+        bitboard.parseFEN(fen);
+        expectCaptureMovesMatch(bitboard, 2);
+    }
+}
+
+TEST(TestBitboard, nullMove) {
+    auto bitboard = chess::Bitboard();
+    bitboard.parseFEN("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3");
+    auto position = bitboard.position();
+    auto hash = bitboard.getHash();
+    auto undo = bitboard.applyNullMove();
+    EXPECT_TRUE(bitboard.getPov());
+    EXPECT_EQ(bitboard.getEnPassantFile(), std::nullopt);
+    EXPECT_EQ(bitboard.getHash(), bitboard.computeHash());
+    EXPECT_NE(bitboard.getHash(), hash);
+    EXPECT_EQ(bitboard.legalMoves().size(), 29);
+    bitboard.unmakeNullMove(undo);
+    EXPECT_TRUE(bitboard.position() == position);
+    EXPECT_FALSE(bitboard.getPov());
+    EXPECT_EQ(bitboard.getHash(), hash);
+    MOVE_IN(bitboard.legalMoves(), "d4e3");
+}
+
+TEST(TestBitboard, compileTimeOffsets) {
+    EXPECT_EQ((chess::Bitboard::canMoveToMask<1, 0>()), 0x7f7f7f7f7f7f7f7full);
+    EXPECT_EQ((chess::Bitboard::canMoveToMask<-2, 1>()), 0x00fcfcfcfcfcfcfcull);
+    EXPECT_EQ((chess::Bitboard::canMoveToMask<0, -2>()), 0xffffffffffff0000ull);
+    EXPECT_EQ((chess::Bitboard::applyOffset<1, 1>(1ull)), 1ull << 9);
+    EXPECT_EQ((chess::Bitboard::applyOffset<-1, -1>(1ull << 9)), 1ull);
+}
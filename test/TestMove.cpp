@@ -4,29 +4,45 @@
 
 TEST(TestMove, UCIConstructor1) {
   auto move = chess::Move("a1a2");
-  EXPECT_EQ(move.fromSquare, 7);
-  EXPECT_EQ(move.toSquare, 15);
-  EXPECT_FALSE(move.promotion);
+  EXPECT_EQ(move.fromSquare(), 7);
+  EXPECT_EQ(move.toSquare(), 15);
+  EXPECT_FALSE(move.promotion());
 }
 
 TEST(TestMove, UCIConstructor2) {
   auto move = chess::Move("e2e4");
-  EXPECT_EQ(move.fromSquare, 11);
-  EXPECT_EQ(move.toSquare, 27);
-  EXPECT_FALSE(move.promotion);
+  EXPECT_EQ(move.fromSquare(), 11);
+  EXPECT_EQ(move.toSquare(), 27);
+  EXPECT_FALSE(move.promotion());
 }
 
 TEST(TestMove, UCIConstructor3) {
   auto move = chess::Move("a8h1");
-  EXPECT_EQ(move.fromSquare, 63);
-  EXPECT_EQ(move.toSquare, 0);
-  EXPECT_FALSE(move.promotion);
+  EXPECT_EQ(move.fromSquare(), 63);
+  EXPECT_EQ(move.toSquare(), 0);
+  EXPECT_FALSE(move.promotion());
 }
 
 TEST(TestMove, UCIConstructorPromotion) {
   auto move = chess::Move("a8h1q");
-  EXPECT_EQ(move.fromSquare, 63);
-  EXPECT_EQ(move.toSquare, 0);
-  ASSERT_TRUE(move.promotion);
-  EXPECT_EQ(move.promotion.value(), 'q');
+  EXPECT_EQ(move.fromSquare(), 63);
+  EXPECT_EQ(move.toSquare(), 0);
+  ASSERT_TRUE(move.promotion());
+  EXPECT_EQ(move.promotion().value(), 'q');
+}
+
+TEST(TestMove, PackedSize) {
+  EXPECT_EQ(sizeof(chess::Move), 2);
+}
+
+TEST(TestMove, ToUCIRoundTrip) {
+  for (auto uci : {"a1a2", "e2e4", "h7h8q", "b2a1n", "c7c8r", "g2g1b"}) {
+    EXPECT_EQ(chess::Move(uci).toUCI(), uci);
+  }
+}
+
+TEST(TestMove, PromotionEquality) {
+  EXPECT_EQ(chess::Move("a7a8q"), chess::Move(55, 63, 'q'));
+  EXPECT_FALSE(chess::Move("a7a8q") == chess::Move("a7a8n"));
+  EXPECT_FALSE(chess::Move("a7a8q") == chess::Move("a7a8"));
 }
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "search/MovePicker.hpp"
+
+namespace {
+    std::vector<std::string> pickAll(const chess::Bitboard &bitboard, chess::Move hashMove = chess::Move()) {
+        chess::MovePicker picker(bitboard, bitboard.legalMoves(), hashMove);
+        std::vector<std::string> result;
+        chess::Move move;
+        while (picker.next(move)) {
+            result.push_back(move.toUCI());
+        }
+        return result;
+    }
+}
+
+TEST(TestMovePicker, PicksEveryMoveOnce) {
+    chess::Bitboard bitboard;
+    bitboard.parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    auto picked = pickAll(bitboard);
+    EXPECT_EQ(picked.size(), 48);
+    std::sort(picked.begin(), picked.end());
+    EXPECT_EQ(std::unique(picked.begin(), picked.end()), picked.end());
+}
+
+TEST(TestMovePicker, HashMoveFirst) {
+    chess::Bitboard bitboard;
+    bitboard.parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    EXPECT_EQ(pickAll(bitboard, chess::Move("a2a3")).front(), "a2a3");
+}
+
+TEST(TestMovePicker, MostValuableVictimLeastValuableAttacker) {
+    chess::Bitboard bitboard;
+    // the queen on d5 is attacked by the pawn and the rook, the knight on h5 by the queen
+    bitboard.parseFEN("4k3/8/8/3q3n/4P3/8/4Q3/3RK3 w - - 0 1");
+    auto picked = pickAll(bitboard);
+    ASSERT_GE(picked.size(), 3);
+    EXPECT_EQ(picked[0], "e4d5");
+    EXPECT_EQ(picked[1], "d1d5");
+    EXPECT_EQ(picked[2], "e2h5");
+}
+
+TEST(TestMovePicker, UnderPromotionsLast) {
+    chess::Bitboard bitboard;
+    bitboard.parseFEN("8/P3k3/8/8/8/8/8/4K3 w - - 0 1");
+    auto picked = pickAll(bitboard);
+    EXPECT_EQ(picked.front(), "a7a8q");
+    EXPECT_EQ(picked.back().size(), 5);
+}
+
+TEST(TestMovePicker, KillersAndHistory) {
+    chess::Bitboard bitboard;
+    bitboard.parseFEN("4k3/8/8/3q4/4P3/8/8/4K1N1 w - - 0 1");
+    chess::MoveHistory history;
+    chess::Move tried[] = {chess::Move("g1f3")};
+    history.onCutoff(true, 3, 4, chess::Move("g1h3"), chess::Move(), std::begin(tried), std::end(tried));
+    EXPECT_TRUE(history.isKiller(3, chess::Move("g1h3"), 0));
+    EXPECT_GT(history.historyScore(true, chess::Move("g1h3")), 0);
+    EXPECT_LT(history.historyScore(true, chess::Move("g1f3")), 0);
+
+    chess::MovePicker picker(bitboard, bitboard.legalMoves(), chess::Move(), &history, 3);
+    chess::Move move;
+    ASSERT_TRUE(picker.next(move));
+    EXPECT_EQ(move.toUCI(), "e4d5");
+    ASSERT_TRUE(picker.next(move));
+    EXPECT_EQ(move.toUCI(), "g1h3");
+    chess::Move last;
+    while (picker.next(move)) last = move;
+    EXPECT_EQ(last.toUCI(), "g1f3");
+
+    history.age();
+    EXPECT_FALSE(history.isKiller(3, chess::Move("g1h3"), 0));
+    history.clear();
+    EXPECT_EQ(history.historyScore(true, chess::Move("g1h3")), 0);
+}
+
+TEST(TestMovePicker, CounterMove) {
+    chess::Bitboard bitboard;
+    bitboard.parseFEN("4k3/8/8/8/8/8/8/4K1N1 w - - 0 1");
+    chess::MoveHistory history;
+    history.onCutoff(true, 5, 1, chess::Move("g1e2"), chess::Move("e7e8"), nullptr, nullptr);
+    EXPECT_EQ(history.counterMove(chess::Move("e7e8")), chess::Move("g1e2"));
+    // a different ply has no killer, the counter move still ranks first
+    chess::MovePicker picker(bitboard, bitboard.legalMoves(), chess::Move(), &history, 1, chess::Move("e7e8"));
+    chess::Move move;
+    ASSERT_TRUE(picker.next(move));
+    EXPECT_EQ(move.toUCI(), "g1e2");
+}
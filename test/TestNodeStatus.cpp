@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "State.hpp"
+
+using chess::NodeStatus;
+
+namespace {
+    NodeStatus statusOf(std::string_view fen) {
+        chess::State state;
+        state.parseFen(fen);
+        return state.status();
+    }
+}
+
+TEST(TestNodeStatus, GameOver) {
+    EXPECT_EQ(statusOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), NodeStatus::Ongoing);
+    EXPECT_EQ(statusOf("4k3/4Q3/4K3/8/8/8/8/8 b - - 0 1"), NodeStatus::Checkmate);
+    EXPECT_EQ(statusOf("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"), NodeStatus::Stalemate);
+    EXPECT_EQ(statusOf("4k3/8/8/8/8/8/8/3NK3 w - - 0 1"), NodeStatus::InsufficientMaterial);
+    EXPECT_EQ(statusOf("4k3/8/8/8/8/8/8/R3K3 w - - 100 80"), NodeStatus::FiftyMoves);
+    // mate takes precedence over the fifty move rule
+    EXPECT_EQ(statusOf("4k3/4Q3/4K3/8/8/8/8/8 b - - 100 80"), NodeStatus::Checkmate);
+}
+
+TEST(TestNodeStatus, MovesOfOngoingNode) {
+    chess::State state;
+    state.reset();
+    chess::MoveList moves;
+    EXPECT_EQ(state.status(0, moves), NodeStatus::Ongoing);
+    EXPECT_EQ(moves.size(), 20u);
+}
+
+TEST(TestNodeStatus, Repetition) {
+    chess::State state;
+    state.reset();
+    for (auto move : {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+        state.pushMove(chess::Move(move));
+    }
+    EXPECT_EQ(state.status(), NodeStatus::Ongoing);
+    EXPECT_EQ(state.status(5), NodeStatus::Repetition);
+    EXPECT_FALSE(state.isGameOver());
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "Perft.hpp"
+
+namespace {
+    void expectPerft(std::string_view fen, unsigned depth, uint64_t nodes) {
+        auto bitboard = chess::Bitboard();
+        bitboard.parseFEN(fen);
+        EXPECT_EQ(chess::Perft::count(bitboard, depth), nodes);
+    }
+}
+
+TEST(TestPerft, Startpos) {
+    auto bitboard = chess::Bitboard();
+    bitboard.startpos();
+    EXPECT_EQ(chess::Perft::count(bitboard, 1), 20);
+    EXPECT_EQ(chess::Perft::count(bitboard, 2), 400);
+    EXPECT_EQ(chess::Perft::count(bitboard, 3), 8902);
+    EXPECT_EQ(chess::Perft::count(bitboard, 4), 197281);
+}
+
+TEST(TestPerft, Kiwipete) {
+    expectPerft("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 1, 48);
+    expectPerft("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2, 2039);
+    expectPerft("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862);
+}
+
+TEST(TestPerft, EnPassantUnderCheck) {
+    expectPerft("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238);
+    expectPerft("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624);
+}
+
+TEST(TestPerft, Promotions) {
+    expectPerft("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467);
+    expectPerft("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379);
+}
+
+TEST(TestPerft, DoubleCheck) {
+    expectPerft("4r2k/8/8/8/8/3n4/8/R3K3 w Q - 0 1", 1, 3);
+}
+
+TEST(TestPerft, Divide) {
+    auto bitboard = chess::Bitboard();
+    bitboard.startpos();
+    auto divided = chess::Perft::divide(bitboard, 3);
+    EXPECT_EQ(divided.size(), 20);
+    uint64_t nodes = 0;
+    for (const auto &[move, moveNodes] : divided) {
+        if (move.toUCI() == "e2e4") {
+            EXPECT_EQ(moveNodes, 600);
+        }
+        nodes += moveNodes;
+    }
+    EXPECT_EQ(nodes, 8902);
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "search/PrincipalVariationTable.hpp"
+
+namespace {
+    std::vector<std::string> toUCI(std::span<const chess::Move> line) {
+        std::vector<std::string> result;
+        for (auto move : line) result.push_back(move.toUCI());
+        return result;
+    }
+}
+
+TEST(TestPrincipalVariationTable, UpdateCopiesChildLine) {
+    chess::PrincipalVariationTable table;
+    table.clear(0);
+    table.clear(1);
+    table.clear(2);
+    table.update(2, chess::Move("g1f3"));
+    table.update(1, chess::Move("e7e5"));
+    table.update(0, chess::Move("e2e4"));
+    EXPECT_EQ(toUCI(table.line(0)), (std::vector<std::string>{"e2e4", "e7e5", "g1f3"}));
+    EXPECT_EQ(table.bestMove(1).toUCI(), "e7e5");
+
+    // a better move at ply 1 replaces the whole line below it
+    table.clear(2);
+    table.update(1, chess::Move("c7c5"));
+    table.update(0, chess::Move("e2e4"));
+    EXPECT_EQ(toUCI(table.line(0)), (std::vector<std::string>{"e2e4", "c7c5"}));
+}
+
+TEST(TestPrincipalVariationTable, ClearAndSet) {
+    chess::PrincipalVariationTable table;
+    table.clear(3);
+    EXPECT_TRUE(table.line(3).empty());
+    EXPECT_EQ(table.bestMove(3), chess::Move());
+    table.set(3, chess::Move("d2d4"));
+    EXPECT_EQ(toUCI(table.line(3)), (std::vector<std::string>{"d2d4"}));
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "Cuckoo.hpp"
+#include "State.hpp"
+#include "Zobrist.hpp"
+
+namespace {
+    void playMoves(chess::State &state, std::initializer_list<std::string_view> moves) {
+        for (auto move : moves) {
+            state.pushMove(chess::Move(move));
+        }
+    }
+}
+
+TEST(TestRepetition, Threefold) {
+    chess::State state;
+    state.reset();
+    playMoves(state, {"g1f3", "g8f6", "f3g1", "f6g8"});
+    EXPECT_FALSE(state.isTreefoldRepetition());
+    EXPECT_FALSE(state.isGameOver());
+    playMoves(state, {"g1f3", "g8f6", "f3g1", "f6g8"});
+    EXPECT_TRUE(state.isTreefoldRepetition());
+    EXPECT_TRUE(state.isGameOver());
+    state.popMove();
+    EXPECT_FALSE(state.isTreefoldRepetition());
+}
+
+TEST(TestRepetition, TwofoldInsideSearch) {
+    chess::State state;
+    state.reset();
+    playMoves(state, {"g1f3", "g8f6", "f3g1", "f6g8"});
+    // the first occurrence is the root, which does not count as part of the search
+    EXPECT_FALSE(state.isRepetition(4));
+    state.reset();
+    playMoves(state, {"e2e4", "g8f6", "g1f3", "f6g8", "f3g1"});
+    // searched from the start position, the position after e2e4 repeats inside the search tree
+    EXPECT_TRUE(state.isRepetition(5));
+    EXPECT_FALSE(state.isRepetition(0));
+}
+
+TEST(TestRepetition, WindowStartsAtIrreversibleMove) {
+    chess::State state;
+    state.parseFen("4k3/8/8/8/8/8/4P3/R3K3 w - - 0 1");
+    playMoves(state, {"a1a2", "e8d8", "a2a1", "d8e8", "e2e3", "e8d8", "a1a2", "d8e8"});
+    EXPECT_FALSE(state.isRepetition(100));
+    // repeats the position right after the pawn move, which is the first one inside the window
+    playMoves(state, {"a2a1"});
+    EXPECT_TRUE(state.isRepetition(100));
+    EXPECT_FALSE(state.isRepetition(0));
+}
+
+TEST(TestRepetition, NullMoveEndsWindow) {
+    chess::State state;
+    state.parseFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    playMoves(state, {"a1a2", "e8d8"});
+    state.pushNullMove();
+    playMoves(state, {"d8e8"});
+    state.pushNullMove();
+    playMoves(state, {"e8d8"});
+    EXPECT_FALSE(state.isRepetition(100));
+}
+
+TEST(TestRepetition, UpcomingRepetition) {
+    chess::State state;
+    state.reset();
+    playMoves(state, {"e2e4", "g8f6", "g1f3"});
+    // f6g8 does not repeat anything, white's knight is still on f3
+    EXPECT_FALSE(state.hasUpcomingRepetition(100));
+    playMoves(state, {"f6g8"});
+    EXPECT_FALSE(state.isRepetition(100));
+    // f3g1 returns to the position after e2e4, which is part of the search tree only if the root lies before it
+    EXPECT_TRUE(state.hasUpcomingRepetition(4));
+    EXPECT_FALSE(state.hasUpcomingRepetition(3));
+}
+
+TEST(TestRepetition, UpcomingRepetitionNeedsFreePath) {
+    // the rook detour a1-b1-b5-a5 adds up to a1-a5 while the king walk only cancels out over all four moves
+    std::initializer_list<std::string_view> moves = {"e8e7", "a1b1", "e7d7", "b1b5", "d7e7", "b5a5", "e7e8"};
+    chess::State state;
+    state.parseFen("4k3/8/8/8/8/8/8/R3K3 b - - 0 1");
+    playMoves(state, moves);
+    EXPECT_TRUE(state.hasUpcomingRepetition(100));
+    // the pawn on a3 blocks the way back
+    state.parseFen("4k3/8/8/8/8/P7/8/R3K3 b - - 0 1");
+    playMoves(state, moves);
+    EXPECT_FALSE(state.hasUpcomingRepetition(100));
+}
+
+TEST(TestRepetition, CuckooTables) {
+    auto rookMove = chess::Zobrist::piece(true, 'r', 0) ^ chess::Zobrist::piece(true, 'r', 7) ^ chess::Zobrist::side();
+    EXPECT_EQ(chess::Cuckoo::find(rookMove), chess::Move(0, 7));
+    auto knightJump = chess::Zobrist::piece(false, 'n', 0) ^ chess::Zobrist::piece(false, 'n', 7) ^ chess::Zobrist::side();
+    EXPECT_EQ(chess::Cuckoo::find(knightJump), chess::Move());
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "search/SearchValue.hpp"
+
+using chess::SearchValue;
+
+TEST(TestSearchValue, FromScore) {
+    EXPECT_EQ(SearchValue::fromScore(chess::Score(120), true, 3), 120);
+    EXPECT_EQ(SearchValue::fromScore(chess::Score(120), false, 3), -120);
+    EXPECT_EQ(SearchValue::fromScore(chess::Score(100000), true, 0), SearchValue::maxCentipawns);
+    // white to move is mated
+    EXPECT_EQ(SearchValue::fromScore(chess::Score(true, -1), true, 3), SearchValue::matedIn(3));
+    // black to move is mated
+    EXPECT_EQ(SearchValue::fromScore(chess::Score(true, 1), false, 5), SearchValue::matedIn(5));
+    EXPECT_TRUE(SearchValue::isMate(SearchValue::matedIn(5)));
+    EXPECT_FALSE(SearchValue::isMate(SearchValue::maxCentipawns));
+}
+
+TEST(TestSearchValue, ToScore) {
+    EXPECT_EQ(SearchValue::toScore(35, true), chess::Score(35));
+    EXPECT_EQ(SearchValue::toScore(35, false), chess::Score(-35));
+    // mate found three plies from the root is a mate in two moves
+    auto score = SearchValue::toScore(SearchValue::mateIn(3), false);
+    EXPECT_TRUE(score.isMate);
+    EXPECT_EQ(score.value, -2);
+    score = SearchValue::toScore(SearchValue::matedIn(2), true);
+    EXPECT_TRUE(score.isMate);
+    EXPECT_EQ(score.value, -1);
+}
+
+TEST(TestSearchValue, TranspositionTableRoundTrip) {
+    for (int value : {0, -250, SearchValue::mateIn(7), SearchValue::matedIn(4)}) {
+        EXPECT_EQ(SearchValue::fromTranspositionTable(SearchValue::toTranspositionTable(value, 3), 3), value);
+    }
+    // a mate stored three plies from the root is one ply closer when found at ply four
+    int stored = SearchValue::toTranspositionTable(SearchValue::mateIn(7), 3);
+    EXPECT_EQ(SearchValue::fromTranspositionTable(stored, 4), SearchValue::mateIn(8));
+}
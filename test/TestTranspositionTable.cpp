@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "search/TranspositionTable.hpp"
+
+using chess::TranspositionTable;
+using Bound = chess::TranspositionTable::Bound;
+
+TEST(TestTranspositionTable, StoreAndProbe) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry{};
+    EXPECT_FALSE(table.probe(0x1234567890abcdefull, entry));
+
+    table.store(0x1234567890abcdefull, chess::Move("e2e4"), 42, 5, Bound::Exact);
+    ASSERT_TRUE(table.probe(0x1234567890abcdefull, entry));
+    EXPECT_EQ(entry.move, chess::Move("e2e4"));
+    EXPECT_EQ(entry.value, 42);
+    EXPECT_EQ(entry.depth, 5);
+    EXPECT_EQ(entry.bound, Bound::Exact);
+
+    EXPECT_FALSE(table.probe(0x1234567890abcdeeull, entry));
+}
+
+TEST(TestTranspositionTable, Overwrite) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry{};
+    table.store(42, chess::Move("a7a8q"), -17, 3, Bound::Lower);
+    table.store(42, chess::Move("g1f3"), 5, 4, Bound::Upper);
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(entry.move, chess::Move("g1f3"));
+    EXPECT_EQ(entry.value, 5);
+    EXPECT_EQ(entry.bound, Bound::Upper);
+}
+
+TEST(TestTranspositionTable, DepthPreferred) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry{};
+    table.store(42, chess::Move("e2e4"), 30, 6, Bound::Lower);
+    // a shallower bound keeps the deeper entry
+    table.store(42, chess::Move("g1f3"), 5, 2, Bound::Upper);
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(entry.move, chess::Move("e2e4"));
+    EXPECT_EQ(entry.depth, 6);
+    // an exact value always replaces it
+    table.store(42, chess::Move("d2d4"), 10, 3, Bound::Exact);
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(entry.move, chess::Move("d2d4"));
+    EXPECT_EQ(entry.depth, 3);
+    // and so does any result of a later search
+    table.store(42, chess::Move("e2e4"), 30, 6, Bound::Lower);
+    table.newSearch();
+    table.store(42, chess::Move("c2c4"), 0, 1, Bound::Upper);
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(entry.move, chess::Move("c2c4"));
+}
+
+TEST(TestTranspositionTable, SameBucket) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry{};
+    // keys differing only in the upper bits share a bucket
+    for (uint64_t i = 1; i <= 4; i++) {
+        table.store(i << 48u, chess::Move(i, i + 8), static_cast<int>(i), i, Bound::Exact);
+    }
+    for (uint64_t i = 1; i <= 4; i++) {
+        ASSERT_TRUE(table.probe(i << 48u, entry));
+        EXPECT_EQ(entry.move, chess::Move(i, i + 8));
+    }
+    // the shallowest entry is replaced first
+    table.store(5ull << 48u, chess::Move("e2e4"), 0, 10, Bound::Exact);
+    EXPECT_FALSE(table.probe(1ull << 48u, entry));
+    EXPECT_TRUE(table.probe(4ull << 48u, entry));
+    EXPECT_TRUE(table.probe(5ull << 48u, entry));
+}
+
+TEST(TestTranspositionTable, ClearAndResize) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry{};
+    table.store(7, chess::Move("e2e4"), 1, 1, Bound::Exact);
+    table.clear();
+    EXPECT_FALSE(table.probe(7, entry));
+    table.store(7, chess::Move("e2e4"), 1, 1, Bound::Exact);
+    table.resize(2);
+    EXPECT_FALSE(table.probe(7, entry));
+    EXPECT_EQ(table.hashfull(), 0);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "Bitboard.hpp"
+#include "Zobrist.hpp"
+
+namespace {
+    chess::Bitboard playMoves(std::string_view fen, std::initializer_list<std::string_view> moves) {
+        auto bitboard = chess::Bitboard();
+        bitboard.parseFEN(fen);
+        for (auto move : moves) {
+            bitboard.applyMoveSelf(chess::Move(move));
+        }
+        return bitboard;
+    }
+}
+
+TEST(TestZobrist, startposMatchesFen) {
+    auto bitboard = chess::Bitboard();
+    bitboard.startpos();
+    auto parsed = chess::Bitboard();
+    parsed.parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(bitboard.getHash(), parsed.getHash());
+    EXPECT_EQ(bitboard.getHash(), bitboard.computeHash());
+}
+
+TEST(TestZobrist, sideToMove) {
+    auto white = playMoves("4k3/8/8/8/8/8/8/4K3 w - - 0 1", {});
+    auto black = playMoves("4k3/8/8/8/8/8/8/4K3 b - - 0 1", {});
+    EXPECT_EQ(white.getHash() ^ chess::Zobrist::side(), black.getHash());
+}
+
+TEST(TestZobrist, transposition) {
+    auto first = playMoves("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                           {"g1f3", "g8f6", "b1c3", "b8c6"});
+    auto second = playMoves("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            {"b1c3", "b8c6", "g1f3", "g8f6"});
+    EXPECT_EQ(first.getHash(), second.getHash());
+
+    auto back = playMoves("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                          {"g1f3", "g8f6", "f3g1", "f6g8"});
+    auto start = playMoves("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", {});
+    EXPECT_EQ(back.getHash(), start.getHash());
+}
+
+TEST(TestZobrist, castlingRightsDiffer) {
+    auto moved = playMoves("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", {"e1f1", "e8f8", "f1e1", "f8e8"});
+    auto fresh = playMoves("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", {});
+    auto noRights = playMoves("r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1", {});
+    EXPECT_NE(moved.getHash(), fresh.getHash());
+    EXPECT_EQ(moved.getHash(), noRights.getHash());
+}
+
+TEST(TestZobrist, enPassantOnlyIfCapturable) {
+    auto capturable = playMoves("4k3/8/8/8/3p4/8/4P3/4K3 w - - 0 1", {"e2e4"});
+    auto notCapturable = playMoves("4k3/8/8/8/8/3p4/4P3/4K3 w - - 0 1", {"e2e4"});
+    EXPECT_EQ(capturable.getHash(), capturable.computeHash());
+    EXPECT_EQ(notCapturable.getHash(), notCapturable.computeHash());
+    EXPECT_TRUE(capturable.getEnPassantFile().has_value());
+    EXPECT_FALSE(notCapturable.getEnPassantFile().has_value());
+}
+
+TEST(TestZobrist, incrementalMatchesScratch) {
+    auto bitboard = chess::Bitboard();
+    bitboard.parseFEN("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    auto hash = bitboard.getHash();
+    for (auto move : bitboard.legalMoves()) {
+        auto undo = bitboard.applyMoveSelf(move);
+        EXPECT_EQ(bitboard.getHash(), bitboard.computeHash()) << move.toUCI();
+        for (auto reply : bitboard.legalMoves()) {
+            auto replyUndo = bitboard.applyMoveSelf(reply);
+            EXPECT_EQ(bitboard.getHash(), bitboard.computeHash()) << move.toUCI() << " " << reply.toUCI();
+            bitboard.unmakeMove(replyUndo);
+        }
+        bitboard.unmakeMove(undo);
+        EXPECT_EQ(bitboard.getHash(), hash);
+    }
+}